@@ -23,6 +23,12 @@
 #include "FrameworkWidgetFactory.h"
 #include "Utils_p.h"
 
+#ifdef KDDOCKWIDGETS_QTWIDGETS
+# include "FloatingWindowPool_p.h"
+# include "FramePool_p.h"
+#endif
+
+#include <QCoreApplication>
 #include <QDebug>
 #include <QOperatingSystemVersion>
 
@@ -56,6 +62,10 @@ public:
     FrameworkWidgetFactory *m_frameworkWidgetFactory = nullptr;
     Flags m_flags = Flag_Default;
     qreal m_draggedWindowOpacity = Q_QNAN;
+    int m_maxPlaceholderCount = 0;
+    int m_maxPlaceholderAge = 0;
+    int m_floatingWindowPoolSize = 0;
+    int m_framePoolSize = 0;
 };
 
 Config::Config()
@@ -162,6 +172,58 @@ qreal Config::draggedWindowOpacity() const
     return d->m_draggedWindowOpacity;
 }
 
+void Config::setMaxPlaceholderCount(int count)
+{
+    d->m_maxPlaceholderCount = qMax(0, count);
+}
+
+int Config::maxPlaceholderCount() const
+{
+    return d->m_maxPlaceholderCount;
+}
+
+void Config::setMaxPlaceholderAge(int msecs)
+{
+    d->m_maxPlaceholderAge = qMax(0, msecs);
+}
+
+int Config::maxPlaceholderAge() const
+{
+    return d->m_maxPlaceholderAge;
+}
+
+void Config::setFloatingWindowPoolSize(int count)
+{
+#ifdef KDDOCKWIDGETS_QTWIDGETS
+    d->m_floatingWindowPoolSize = qMax(0, count);
+    if (qApp)
+        FloatingWindowPool::self()->updateSize();
+#else
+    Q_UNUSED(count);
+#endif
+}
+
+int Config::floatingWindowPoolSize() const
+{
+    return d->m_floatingWindowPoolSize;
+}
+
+void Config::setFramePoolSize(int count)
+{
+#ifdef KDDOCKWIDGETS_QTWIDGETS
+    d->m_framePoolSize = qMax(0, count);
+    if (qApp)
+        FramePool::self()->updateSize();
+#else
+    Q_UNUSED(count);
+#endif
+}
+
+int Config::framePoolSize() const
+{
+    return d->m_framePoolSize;
+}
+
 void Config::setTabbingAllowedFunc(TabbingAllowedFunc func)
 {
     d->m_tabbingAllowedFunc = func;
@@ -85,6 +85,9 @@ public:
                                                                     ///< By default it also turns off the float button, but you can remove Flag_TitleBarNoFloatButton to have both.
         Flag_KeepAboveIfNotUtilityWindow = 0x10000, ///< Only meaningful if Flag_DontUseUtilityFloatingWindows is set. If floating windows are normal windows, you might still want them to keep above and not minimize when you focus the main window.
         Flag_internal_NoAeroSnap = 0x20000, ///< Internal flag, only for development. Disables Aero-snap.
+        Flag_CoalesceDragHover = 0x40000, ///< While dragging, the drop area under the cursor and the drop indicators are updated at most once per display refresh, with the latest cursor position. The dragged window still moves on every mouse move. Useful with high-rate input devices.
+        Flag_DeferredDetach = 0x80000, ///< Dragging a docked title bar or tab doesn't detach it immediately. A translucent snapshot follows the mouse instead and the layout is only changed on drop. Releasing it over a layout without picking a drop location leaves it where it was. QtWidgets only, ignored on Wayland.
+        Flag_UniformTabWidths = 0x100000, ///< For frames with many tabs. Tabs have the same width, instead of being measured for their titles, and scroll. They don't have their own close buttons and an overflow button lists every dock widget of the frame, with a search field. Flag_TabsHaveCloseButton adds a single close button for the current tab instead. Each tab is still a QTabBar tab. QtWidgets only.
         Flag_Default = Flag_AeroSnapWithClientDecos ///< The defaults
     };
     Q_DECLARE_FLAGS(Flags, Flag)
@@ -160,6 +163,56 @@ public:
     ///By default it's 1.0, fully opaque
     qreal draggedWindowOpacity() const;
 
+    /**
+     * @brief Sets the maximum number of placeholders a main window keeps for closed dock widgets.
+     *
+     * When exceeded, the placeholders of the dock widgets that were closed longest ago are removed
+     * and those dock widgets will be shown floating next time.
+     * 0 means no limit, which is the default.
+     * @sa MainWindowBase::compactLayout()
+     */
+    void setMaxPlaceholderCount(int count);
+
+    ///@brief returns the value set with @ref setMaxPlaceholderCount()
+    int maxPlaceholderCount() const;
+
+    /**
+     * @brief Sets for how many milliseconds a main window keeps the placeholder of a closed dock widget.
+     *
+     * Expired placeholders are removed and their dock widgets will be shown floating next time.
+     * 0 means no limit, which is the default.
+     * @sa MainWindowBase::compactLayout()
+     */
+    void setMaxPlaceholderAge(int msecs);
+
+    ///@brief returns the value set with @ref setMaxPlaceholderAge()
+    int maxPlaceholderAge() const;
+
+    /**
+     * @brief Sets how many hidden floating windows are kept ready for reuse.
+     *
+     * Creating a native window is the most expensive part of floating a dock widget. With a pool,
+     * floating windows which become empty are hidden and reused instead of deleted, and new ones
+     * are created in advance when the application is idle.
+     * 0 disables the pool, which is the default. Only supported with QtWidgets.
+     */
+    void setFloatingWindowPoolSize(int count);
+
+    ///@brief returns the value set with @ref setFloatingWindowPoolSize()
+    int floatingWindowPoolSize() const;
+
+    /**
+     * @brief Sets how many empty frames are kept ready for reuse.
+     *
+     * Docking, undocking and restoring layouts create and delete many frames, each with its own
+     * title bar and tab widget. With a pool, frames which become empty are reset and reused instead.
+     * 0 disables the pool, which is the default. Only supported with QtWidgets.
+     */
+    void setFramePoolSize(int count);
+
+    ///@brief returns the value set with @ref setFramePoolSize()
+    int framePoolSize() const;
+
     /**
      * @brief Allows the user to intercept a docking attempt to center (tabbed) and disallow it.
      *
@@ -66,6 +66,11 @@ public:
 
         toggleAction->setCheckable(true);
         floatAction->setCheckable(true);
+
+        hibernationTimer.setSingleShot(true);
+        q->connect(&hibernationTimer, &QTimer::timeout, q, [this] {
+            hibernate();
+        });
     }
 
     void init()
@@ -118,6 +123,18 @@ public:
      */
     void saveTabIndex();
 
+    ///@brief sets the size constraints the layout uses while there's no widget
+    void setPlaceholderSizes(QSize minSize, QSize maxSize);
+
+    ///@brief restores the size constraints overridden by setPlaceholderSizes()
+    void restoreSizes();
+
+    ///@brief releases the widget, if the dock widget was hidden for long enough. @sa setHibernation()
+    void hibernate();
+
+    ///@brief computes the sizes returned by cachedMinSize() and cachedMaxSize(), if they're stale
+    void ensureCachedSizes();
+
     const QString name;
     QStringList affinities;
     QString title;
@@ -129,6 +146,18 @@ public:
     QAction *const toggleAction;
     QAction *const floatAction;
     LastPositions m_lastPositions;
+    WidgetFactoryFunc widgetFactory;
+    HibernateFunc hibernateFunc;
+    QTimer hibernationTimer;
+    qint64 hibernatedBytes = -1; // -1 if not hibernated
+    QSize minimumSizeBeforePlaceholder;
+    QSize maximumSizeBeforePlaceholder;
+    bool usesPlaceholderSizes = false;
+    bool creatingWidget = false;
+    QSize cachedMinSize;
+    QSize cachedMaxSize;
+    bool cachedSizesValid = false;
+    int numSizeComputations = 0;
     bool m_updatingToggleAction = false;
     bool m_updatingFloatAction = false;
     bool m_isForceClosing = false;
@@ -241,6 +270,11 @@ void DockWidgetBase::setWidget(QWidgetOrQuick *w)
     if (w == d->widget)
         return;
 
+    if (!d->creatingWidget)
+        d->widgetFactory = nullptr; // The user is managing the widget now
+    d->restoreSizes();
+    invalidateCachedSizes();
+
     if (d->widget) {
         // Unparent the old widget, we're giving back ownership
         d->widget->setParent(nullptr);
@@ -259,6 +293,100 @@ QWidgetOrQuick *DockWidgetBase::widget() const
     return d->widget;
 }
 
+void DockWidgetBase::setWidgetFactory(const WidgetFactoryFunc &factory, QSize minSize, QSize maxSize)
+{
+    if (d->widget) {
+        qWarning() << Q_FUNC_INFO << "Already has a widget" << d->widget;
+        return;
+    }
+
+    if (!factory) {
+        qWarning() << Q_FUNC_INFO << "Factory can't be null";
+        return;
+    }
+
+    d->widgetFactory = factory;
+
+    // Until the guest exists, these are the constraints the layout sees
+    d->setPlaceholderSizes(minSize, maxSize);
+
+    if (isVisible())
+        maybeCreateWidget();
+}
+
+void DockWidgetBase::setHibernation(int idleMsecs, const HibernateFunc &func)
+{
+    d->hibernateFunc = idleMsecs > 0 ? func : nullptr;
+    if (!d->hibernateFunc) {
+        d->hibernationTimer.stop();
+        return;
+    }
+
+    if (!d->widgetFactory)
+        qWarning() << Q_FUNC_INFO << "Hibernation requires a widget factory, to recreate the widget" << uniqueName();
+
+    d->hibernationTimer.setInterval(idleMsecs);
+    if (!isVisible())
+        d->hibernationTimer.start();
+}
+
+bool DockWidgetBase::isHibernated() const
+{
+    return d->hibernatedBytes >= 0;
+}
+
+qint64 DockWidgetBase::hibernatedBytes() const
+{
+    return qMax<qint64>(0, d->hibernatedBytes);
+}
+
+void DockWidgetBase::maybeCreateWidget()
+{
+    if (!d->widgetFactory || d->widget)
+        return;
+
+    qCDebug(creation) << Q_FUNC_INFO << "Creating widget for" << this
+                      << "; hibernated=" << isHibernated();
+
+    d->restoreSizes();
+    d->hibernatedBytes = -1;
+
+    QScopedValueRollback<bool> guard(d->creatingWidget, true);
+    if (QWidgetOrQuick *w = d->widgetFactory()) {
+        setWidget(w);
+    } else {
+        qWarning() << Q_FUNC_INFO << "Widget factory returned nullptr for" << uniqueName();
+    }
+}
+
+QSize DockWidgetBase::cachedMinSize() const
+{
+    d->ensureCachedSizes();
+    return d->cachedMinSize;
+}
+
+QSize DockWidgetBase::cachedMaxSize() const
+{
+    d->ensureCachedSizes();
+    return d->cachedMaxSize;
+}
+
+void DockWidgetBase::invalidateCachedSizes()
+{
+    d->cachedSizesValid = false;
+}
+
+int DockWidgetBase::dbg_numSizeComputations() const
+{
+    return d->numSizeComputations;
+}
+
+void DockWidgetBase::onLayoutRequest()
+{
+    // The layout was already activated at this point, so the new constraints are known
+    invalidateCachedSizes();
+}
+
 bool DockWidgetBase::isFloating() const
 {
     if (isWindow())
@@ -660,8 +788,69 @@ void DockWidgetBase::Private::updateFloatAction()
     }
 }
 
+void DockWidgetBase::Private::setPlaceholderSizes(QSize minSize, QSize maxSize)
+{
+    if (!usesPlaceholderSizes) {
+        minimumSizeBeforePlaceholder = q->minimumSize();
+        maximumSizeBeforePlaceholder = q->maximumSize();
+        usesPlaceholderSizes = true;
+    }
+
+    if (minSize.isValid())
+        q->setMinimumSize(minSize);
+    if (maxSize.isValid())
+        q->setMaximumSize(maxSize);
+
+    q->invalidateCachedSizes();
+}
+
+void DockWidgetBase::Private::restoreSizes()
+{
+    if (!usesPlaceholderSizes)
+        return;
+
+    usesPlaceholderSizes = false;
+    q->setMinimumSize(minimumSizeBeforePlaceholder);
+    q->setMaximumSize(maximumSizeBeforePlaceholder);
+    q->invalidateCachedSizes();
+}
+
+void DockWidgetBase::Private::ensureCachedSizes()
+{
+    if (cachedSizesValid)
+        return;
+
+    cachedMinSize = Layouting::Widget::widgetMinSize(q);
+    cachedMaxSize = Layouting::Widget::widgetMaxSize(q);
+    cachedSizesValid = true;
+    numSizeComputations++;
+}
+
+void DockWidgetBase::Private::hibernate()
+{
+    if (!widget || !widgetFactory || !hibernateFunc || q->isVisible())
+        return;
+
+    const qint64 bytes = hibernateFunc(widget);
+    if (bytes < 0) {
+        qCDebug(hiding) << Q_FUNC_INFO << "Application kept the widget of" << q;
+        return;
+    }
+
+    qCDebug(hiding) << Q_FUNC_INFO << q << "releasing" << bytes << "bytes";
+
+    // Keep the constraints the layout is using, which come from the guest, so the layout doesn't change
+    setPlaceholderSizes(q->cachedMinSize(), q->cachedMaxSize());
+
+    QWidgetOrQuick *guest = widget;
+    widget = nullptr;
+    delete guest;
+    hibernatedBytes = bytes;
+}
+
 void DockWidgetBase::Private::onDockWidgetShown()
 {
+    hibernationTimer.stop();
     updateToggleAction();
     updateFloatAction();
 }
@@ -670,6 +859,9 @@ void DockWidgetBase::Private::onDockWidgetHidden()
 {
     updateToggleAction();
     updateFloatAction();
+
+    if (hibernateFunc && widget)
+        hibernationTimer.start();
 }
 
 void DockWidgetBase::Private::close()
@@ -768,6 +960,7 @@ void DockWidgetBase::onParentChanged()
 
 void DockWidgetBase::onShown(bool spontaneous)
 {
+    maybeCreateWidget();
     d->onDockWidgetShown();
     Q_EMIT shown();
 
@@ -26,6 +26,8 @@
 
 #include <QVector>
 
+#include <functional>
+
 QT_BEGIN_NAMESPACE
 class QAction;
 QT_END_NAMESPACE
@@ -137,6 +139,8 @@ class DOCKS_EXPORT DockWidgetBase : public QWidget
     Q_PROPERTY(bool isFloating READ isFloating WRITE setFloating NOTIFY isFloatingChanged)
 public:
     typedef QVector<DockWidgetBase *> List;
+    typedef std::function<QWidgetOrQuick *()> WidgetFactoryFunc;
+    typedef std::function<qint64(QWidgetOrQuick *)> HibernateFunc;
 
     ///@brief DockWidget options to pass at construction time
     enum Option {
@@ -215,9 +219,45 @@ public:
 
     /**
      * @brief returns the widget which this dock widget hosts
+     *
+     * Returns nullptr if a widget factory was set and the dock widget wasn't shown yet.
+     * @sa setWidgetFactory()
      */
     QWidgetOrQuick *widget() const;
 
+#ifndef PYTHON_BINDINGS
+    /**
+     * @brief Sets a function which creates the hosted widget when it's first needed, instead of upfront.
+     *
+     * The widget is created and passed to setWidget() when the dock widget is shown for the first
+     * time, for example when its tab becomes current. Until then widget() returns nullptr and the
+     * layout uses @p minSize and @p maxSize, if valid, as if they were the widget's.
+     *
+     * Useful for dock widgets which start in a background tab and might never be looked at.
+     * Does nothing if a widget was already set.
+     */
+    void setWidgetFactory(const WidgetFactoryFunc &factory, QSize minSize = {}, QSize maxSize = {});
+
+    /**
+     * @brief Deletes the hosted widget once the dock widget was hidden for @p idleMsecs.
+     *
+     * Being closed, in a side bar or behind another tab all count as hidden. Before deleting it,
+     * @p func is called with the widget, so the application can save its state. It returns roughly
+     * how much memory the widget used, in bytes, or -1 to keep the widget for now.
+     *
+     * Requires setWidgetFactory(), which recreates the widget next time the dock widget is shown.
+     * Pass 0 as @p idleMsecs to disable, which is the default.
+     * @sa isHibernated(), DockRegistry::hibernatedBytes()
+     */
+    void setHibernation(int idleMsecs, const HibernateFunc &func);
+#endif
+
+    ///@brief Returns whether the hosted widget was deleted due to hibernation. @sa setHibernation()
+    bool isHibernated() const;
+
+    ///@brief Returns the memory released by hibernating, as reported by the hibernation function
+    qint64 hibernatedBytes() const;
+
     /**
      * @brief Returns whether the dock widget is floating.
      * Floating means it's not docked and has a window of its own.
@@ -492,6 +532,7 @@ protected:
     void onShown(bool spontaneous);
     void onHidden(bool spontaneous);
 #ifndef PYTHON_BINDINGS //Pyside bug: https://bugreports.qt.io/projects/PYSIDE/issues/PYSIDE-1327
+    void onLayoutRequest() override;
     void onCloseEvent(QCloseEvent *e) override;
 #endif
 
@@ -516,6 +557,23 @@ public:
 private:
 #endif
     Q_DISABLE_COPY(DockWidgetBase)
+
+    ///@brief creates the widget, if a factory was set with setWidgetFactory() and it wasn't created yet
+    void maybeCreateWidget();
+
+    ///@brief returns the minimum size the layout should honour.
+    /// Cached until the next LayoutRequest or explicit constraint change, as computing it is expensive
+    QSize cachedMinSize() const;
+
+    ///@brief returns the maximum size the layout should honour. @sa cachedMinSize()
+    QSize cachedMaxSize() const;
+
+    ///@brief discards the sizes cached by cachedMinSize() and cachedMaxSize()
+    void invalidateCachedSizes();
+
+    ///@brief For debugging purposes. Returns how many times the cached sizes were computed.
+    int dbg_numSizeComputations() const;
+
     friend class MultiSplitter;
     friend class Frame;
     friend class DropArea;
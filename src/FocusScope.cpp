@@ -36,17 +36,19 @@ public:
         : q(qq)
         , m_thisWidget(thisWidget)
     {
-        connect(qApp, &QGuiApplication::focusObjectChanged,
-                this, &Private::onFocusObjectChanged);
-
-        onFocusObjectChanged(qApp->focusObject());
+        // Afterwards, DockRegistry tells us when we gain or lose focus
+        QObject *focusObject = qApp->focusObject();
+        auto widget = qobject_cast<WidgetType*>(focusObject);
+        onFocusObjectChanged(focusObject, widget && isInFocusScope(widget));
         m_inCtor = false;
+
+        DockRegistry::self()->registerFocusScope(q, m_thisWidget);
     }
 
     ~Private() override;
 
     void setIsFocused(bool);
-    void onFocusObjectChanged(QObject *);
+    void onFocusObjectChanged(QObject *, bool isInScope);
     bool isInFocusScope(WidgetType *) const;
     void emitDockWidgetFocusChanged();
 
@@ -59,6 +61,7 @@ public:
 
 FocusScope::Private::~Private()
 {
+    DockRegistry::self()->unregisterFocusScope(m_thisWidget);
 }
 
 FocusScope::FocusScope(QWidgetAdapter *thisWidget)
@@ -83,7 +86,8 @@ WidgetType *FocusScope::focusedWidget() const
 
 void FocusScope::focus(Qt::FocusReason reason)
 {
-    if (d->m_lastFocusedInScope) {
+    // The widget might have moved to another scope meanwhile, for example if this Frame was recycled
+    if (d->m_lastFocusedInScope && d->isInFocusScope(d->m_lastFocusedInScope)) {
         d->m_lastFocusedInScope->setFocus(reason);
     } else {
         if (auto frame = qobject_cast<Frame*>(d->m_thisWidget)) {
@@ -113,7 +117,12 @@ void FocusScope::Private::setIsFocused(bool is)
     }
 }
 
-void FocusScope::Private::onFocusObjectChanged(QObject *obj)
+void FocusScope::onFocusObjectChanged(QObject *obj, bool isInScope)
+{
+    d->onFocusObjectChanged(obj, isInScope);
+}
+
+void FocusScope::Private::onFocusObjectChanged(QObject *obj, bool is)
 {
     auto widget = qobject_cast<WidgetType*>(obj);
     if (!widget) {
@@ -121,7 +130,6 @@ void FocusScope::Private::onFocusObjectChanged(QObject *obj)
         return;
     }
 
-    const bool is = isInFocusScope(widget);
     if (is && m_lastFocusedInScope != widget && !qobject_cast<TitleBar*>(obj)) {
         m_lastFocusedInScope = widget;
         setIsFocused(is);
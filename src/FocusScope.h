@@ -52,6 +52,11 @@ public:
     virtual void isFocusedChanged() = 0;
     virtual void focusedWidgetChanged() = 0;
 
+protected:
+    friend class DockRegistry;
+    ///@brief Called by DockRegistry when the focus object changed and this scope is, or was, focused
+    void onFocusObjectChanged(QObject *obj, bool isInScope);
+
 private:
     class Private;
     Private *const d;
@@ -28,6 +28,8 @@
 # include "widgets/TabWidgetWidget_p.h"
 # include "multisplitter/Separator_qwidget.h"
 # include "widgets/FloatingWindowWidget_p.h"
+# include "FloatingWindowPool_p.h"
+# include "FramePool_p.h"
 # include "indicators/SegmentedIndicators_p.h"
 
 # include <QRubberBand>
@@ -52,6 +54,11 @@ FrameworkWidgetFactory::~FrameworkWidgetFactory()
 #ifdef KDDOCKWIDGETS_QTWIDGETS
 Frame *DefaultWidgetFactory::createFrame(QWidgetOrQuick *parent, FrameOptions options) const
 {
+    if (options == FrameOption_None && Config::self().framePoolSize() > 0) {
+        if (Frame *frame = FramePool::self()->take(parent))
+            return frame;
+    }
+
     return new FrameWidget(parent, options);
 }
 
@@ -87,6 +94,11 @@ FloatingWindow *DefaultWidgetFactory::createFloatingWindow(MainWindowBase *paren
 
 FloatingWindow *DefaultWidgetFactory::createFloatingWindow(Frame *frame, MainWindowBase *parent) const
 {
+    if (Config::self().floatingWindowPoolSize() > 0) {
+        if (FloatingWindow *fw = FloatingWindowPool::self()->take(frame, parent))
+            return fw;
+    }
+
     return new FloatingWindowWidget(frame, parent);
 }
 
@@ -0,0 +1,469 @@
+/*
+  This file is part of KDDockWidgets.
+
+  SPDX-FileCopyrightText: 2019-2020 Klarälvdalens Datakonsult AB, a KDAB Group company <info@kdab.com>
+  Author: Sérgio Martins <sergio.martins@kdab.com>
+
+  SPDX-License-Identifier: GPL-2.0-only OR GPL-3.0-only
+
+  Contact KDAB at <info@kdab.com> for commercial licensing options.
+*/
+
+/**
+ * @file
+ * @brief Class to periodically save the layout to disk, for crash recovery.
+ *
+ * @author Sérgio Martins \<sergio.martins@kdab.com\>
+ */
+
+#include "LayoutAutoSaver.h"
+#include "LayoutSaver.h"
+#include "LayoutSaver_p.h"
+
+#include <QDateTime>
+#include <QDebug>
+#include <QFile>
+#include <QHash>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QMutex>
+#include <QMutexLocker>
+#include <QRunnable>
+#include <QSaveFile>
+#include <QThreadPool>
+#include <QTimer>
+
+#include <memory>
+
+#if defined(Q_OS_WIN)
+# include <io.h>
+#elif defined(Q_OS_UNIX)
+# include <unistd.h>
+#endif
+
+using namespace KDDockWidgets;
+
+namespace {
+
+/// Plain copy of the LayoutSaver::Layout data. It doesn't share anything with the GUI thread,
+/// so it can be encoded on the worker thread while the GUI thread keeps serializing.
+struct Snapshot
+{
+    explicit Snapshot(const LayoutSaver::Layout &layout)
+        : serializationVersion(layout.serializationVersion)
+        , mainWindows(layout.mainWindows)
+        , floatingWindows(layout.floatingWindows)
+        , screenInfo(layout.screenInfo)
+    {
+        // DockWidget::Ptr instances are shared with LayoutSaver::DockWidget::s_dockWidgets,
+        // which the next serialization or restore will write to. Use our own copies.
+        closedDockWidgets.reserve(layout.closedDockWidgets.size());
+        for (const auto &dw : layout.closedDockWidgets)
+            closedDockWidgets.push_back(detached(dw));
+
+        allDockWidgets.reserve(layout.allDockWidgets.size());
+        for (const auto &dw : layout.allDockWidgets)
+            allDockWidgets.push_back(detached(dw));
+
+        for (LayoutSaver::MainWindow &mw : mainWindows)
+            detachFrames(mw.multiSplitterLayout);
+
+        for (LayoutSaver::FloatingWindow &fw : floatingWindows)
+            detachFrames(fw.multiSplitterLayout);
+    }
+
+    static LayoutSaver::DockWidget::Ptr detached(const LayoutSaver::DockWidget::Ptr &dw)
+    {
+        return std::make_shared<LayoutSaver::DockWidget>(*dw);
+    }
+
+    static void detachFrames(LayoutSaver::MultiSplitter &multiSplitter)
+    {
+        for (LayoutSaver::Frame &frame : multiSplitter.frames) {
+            for (auto &dw : frame.dockWidgets)
+                dw = detached(dw);
+        }
+    }
+
+    /// Returns the same top-level keys as LayoutSaver::Layout::toVariantMap(), so the result can
+    /// be loaded by LayoutSaver
+    QVariantMap toVariantMap() const
+    {
+        QVariantMap map;
+        map.insert(QStringLiteral("serializationVersion"), serializationVersion);
+        map.insert(QStringLiteral("mainWindows"), toVariantList<LayoutSaver::MainWindow>(mainWindows));
+        map.insert(QStringLiteral("floatingWindows"), toVariantList<LayoutSaver::FloatingWindow>(floatingWindows));
+        map.insert(QStringLiteral("closedDockWidgets"), ::dockWidgetNames(closedDockWidgets));
+        map.insert(QStringLiteral("allDockWidgets"), toVariantList(allDockWidgets));
+        map.insert(QStringLiteral("screenInfo"), toVariantList<LayoutSaver::ScreenInfo>(screenInfo));
+
+        return map;
+    }
+
+    const int serializationVersion;
+    LayoutSaver::MainWindow::List mainWindows;
+    LayoutSaver::FloatingWindow::List floatingWindows;
+    LayoutSaver::DockWidget::List closedDockWidgets;
+    LayoutSaver::DockWidget::List allDockWidgets;
+    const LayoutSaver::ScreenInfo::List screenInfo;
+
+    // Copied from the LayoutAutoSaver, so the worker doesn't read settings from the GUI thread
+    bool journalingEnabled = false;
+    int journalCompactionThreshold = 0;
+};
+
+/// Written to the main file and to each journal entry. Entries from a different generation are
+/// stale, left over from before the last full write.
+QString generationKey()
+{
+    return QStringLiteral("autoSaverGeneration");
+}
+
+qint64 generationOf(const QJsonObject &obj)
+{
+    return qint64(obj.value(generationKey()).toDouble());
+}
+
+bool syncToDisk(QFile &f)
+{
+    if (!f.flush())
+        return false;
+
+#if defined(Q_OS_WIN)
+    return _commit(f.handle()) == 0;
+#elif defined(Q_OS_UNIX)
+    return ::fsync(f.handle()) == 0;
+#else
+    return true;
+#endif
+}
+
+}
+
+class LayoutAutoSaver::Private
+{
+public:
+    class SaveJob : public QRunnable
+    {
+    public:
+        explicit SaveJob(LayoutAutoSaver::Private *d)
+            : m_d(d)
+        {
+        }
+
+        void run() override
+        {
+            m_d->processPendingSnapshots();
+        }
+
+    private:
+        LayoutAutoSaver::Private *const m_d;
+    };
+
+    Private(LayoutAutoSaver *qq, const QString &fileName)
+        : q(qq)
+        , m_fileName(fileName)
+    {
+        // A single thread, so writes happen in the order they were requested
+        m_pool.setMaxThreadCount(1);
+        m_timer.setInterval(30000);
+    }
+
+    void schedule(const std::shared_ptr<Snapshot> &);
+    void processPendingSnapshots();
+
+    // The following run in the worker thread:
+    bool write(const Snapshot &);
+    bool writeFull(const QJsonObject &);
+    bool appendToJournal(const QJsonObject &entry);
+
+    LayoutAutoSaver *const q;
+    const QString m_fileName;
+    LayoutSaver m_saver;
+    QTimer m_timer;
+    bool m_journalingEnabled = false;
+    int m_journalCompactionThreshold = 20;
+
+    QThreadPool m_pool;
+    QMutex m_mutex;
+    std::shared_ptr<Snapshot> m_pendingSnapshot; // protected by m_mutex
+    bool m_jobScheduled = false; // protected by m_mutex
+
+    // Only accessed by the worker thread:
+    QHash<QString, QByteArray> m_lastWrittenSections;
+    int m_numJournalEntries = 0;
+    qint64 m_journalSize = 0;
+    qint64 m_fileSize = 0;
+    qint64 m_generation = 0;
+};
+
+LayoutAutoSaver::LayoutAutoSaver(const QString &fileName, QObject *parent)
+    : QObject(parent)
+    , d(new Private(this, fileName))
+{
+    connect(&d->m_timer, &QTimer::timeout, this, &LayoutAutoSaver::saveNow);
+}
+
+LayoutAutoSaver::~LayoutAutoSaver()
+{
+    d->m_timer.stop();
+    waitForPendingSaves();
+    delete d;
+}
+
+QString LayoutAutoSaver::fileName() const
+{
+    return d->m_fileName;
+}
+
+void LayoutAutoSaver::setInterval(int msecs)
+{
+    d->m_timer.setInterval(msecs);
+}
+
+int LayoutAutoSaver::interval() const
+{
+    return d->m_timer.interval();
+}
+
+void LayoutAutoSaver::start()
+{
+    d->m_timer.start();
+}
+
+void LayoutAutoSaver::stop()
+{
+    d->m_timer.stop();
+}
+
+bool LayoutAutoSaver::isActive() const
+{
+    return d->m_timer.isActive();
+}
+
+void LayoutAutoSaver::setAffinityNames(const QStringList &affinityNames)
+{
+    d->m_saver.setAffinityNames(affinityNames);
+}
+
+void LayoutAutoSaver::setJournalingEnabled(bool enabled)
+{
+    d->m_journalingEnabled = enabled;
+}
+
+bool LayoutAutoSaver::journalingEnabled() const
+{
+    return d->m_journalingEnabled;
+}
+
+void LayoutAutoSaver::setJournalCompactionThreshold(int numEntries)
+{
+    d->m_journalCompactionThreshold = numEntries;
+}
+
+int LayoutAutoSaver::journalCompactionThreshold() const
+{
+    return d->m_journalCompactionThreshold;
+}
+
+bool LayoutAutoSaver::saveNow()
+{
+    if (LayoutSaver::restoreInProgress())
+        return false;
+
+    LayoutSaver::Layout layout;
+    if (!d->m_saver.serializeLayout(layout))
+        return false;
+
+    auto snapshot = std::make_shared<Snapshot>(layout);
+    snapshot->journalingEnabled = d->m_journalingEnabled;
+    snapshot->journalCompactionThreshold = d->m_journalCompactionThreshold;
+
+    d->schedule(snapshot);
+    return true;
+}
+
+void LayoutAutoSaver::waitForPendingSaves()
+{
+    d->m_pool.waitForDone();
+}
+
+QString LayoutAutoSaver::journalFileName(const QString &fileName)
+{
+    return fileName + QStringLiteral(".journal");
+}
+
+QByteArray LayoutAutoSaver::recoveredLayout(const QString &fileName)
+{
+    QFile f(fileName);
+    if (!f.open(QIODevice::ReadOnly)) {
+        qWarning() << Q_FUNC_INFO << "Failed to open" << fileName << f.errorString();
+        return {};
+    }
+
+    const QByteArray data = f.readAll();
+    QFile journal(journalFileName(fileName));
+    if (!journal.exists())
+        return data;
+
+    if (!journal.open(QIODevice::ReadOnly)) {
+        qWarning() << Q_FUNC_INFO << "Failed to open" << journal.fileName() << journal.errorString();
+        return data;
+    }
+
+    QJsonObject layout = QJsonDocument::fromJson(data).object();
+    const qint64 generation = generationOf(layout);
+    while (!journal.atEnd()) {
+        QJsonParseError error;
+        const QJsonDocument entry = QJsonDocument::fromJson(journal.readLine(), &error);
+        if (error.error != QJsonParseError::NoError) {
+            // Probably the last entry, which was being written when the app crashed
+            qWarning() << Q_FUNC_INFO << "Ignoring invalid journal entry" << error.errorString();
+            continue;
+        }
+
+        const QJsonObject sections = entry.object();
+        if (generationOf(sections) != generation) {
+            // We crashed after writing a newer main file, but before removing the journal
+            continue;
+        }
+
+        for (auto it = sections.constBegin(), end = sections.constEnd(); it != end; ++it) {
+            if (it.key() != generationKey())
+                layout.insert(it.key(), it.value());
+        }
+    }
+
+    return QJsonDocument(layout).toJson();
+}
+
+void LayoutAutoSaver::Private::schedule(const std::shared_ptr<Snapshot> &snapshot)
+{
+    QMutexLocker locker(&m_mutex);
+
+    // If the previous snapshot wasn't picked up yet, it's replaced, as only the newest is interesting
+    m_pendingSnapshot = snapshot;
+
+    if (!m_jobScheduled) {
+        m_jobScheduled = true;
+        m_pool.start(new SaveJob(this));
+    }
+}
+
+void LayoutAutoSaver::Private::processPendingSnapshots()
+{
+    while (true) {
+        std::shared_ptr<Snapshot> snapshot;
+        {
+            QMutexLocker locker(&m_mutex);
+            snapshot = std::move(m_pendingSnapshot);
+            m_pendingSnapshot.reset();
+            if (!snapshot) {
+                m_jobScheduled = false;
+                return;
+            }
+        }
+
+        const bool success = write(*snapshot);
+        Q_EMIT q->saved(success);
+    }
+}
+
+bool LayoutAutoSaver::Private::write(const Snapshot &snapshot)
+{
+    const QVariantMap map = snapshot.toVariantMap();
+
+    QJsonObject layout;
+    QJsonObject changedSections;
+    QHash<QString, QByteArray> encodedSections;
+    for (auto it = map.cbegin(), end = map.cend(); it != end; ++it) {
+        const QJsonValue value = QJsonValue::fromVariant(it.value());
+        layout.insert(it.key(), value);
+
+        QJsonObject section;
+        section.insert(it.key(), value);
+        const QByteArray encoded = QJsonDocument(section).toJson(QJsonDocument::Compact);
+        if (m_lastWrittenSections.value(it.key()) != encoded)
+            changedSections.insert(it.key(), value);
+
+        encodedSections.insert(it.key(), encoded);
+    }
+
+    bool success = true;
+    if (changedSections.isEmpty()) {
+        // Nothing changed since the last write
+    } else if (!snapshot.journalingEnabled || m_lastWrittenSections.isEmpty()
+               || m_numJournalEntries >= snapshot.journalCompactionThreshold
+               || m_journalSize > m_fileSize) {
+        success = writeFull(layout);
+    } else {
+        success = appendToJournal(changedSections);
+    }
+
+    if (success)
+        m_lastWrittenSections = encodedSections;
+    else
+        m_lastWrittenSections.clear(); // So the next one is a full write
+
+    return success;
+}
+
+bool LayoutAutoSaver::Private::writeFull(const QJsonObject &layout)
+{
+    // Unique across runs too, as the journal might be from a previous session
+    const qint64 generation = qMax(QDateTime::currentMSecsSinceEpoch(), m_generation + 1);
+    QJsonObject layoutWithGeneration = layout;
+    layoutWithGeneration.insert(generationKey(), double(generation));
+    const QByteArray data = QJsonDocument(layoutWithGeneration).toJson();
+
+    // QSaveFile writes to a temporary file, syncs it to disk and then renames it,
+    // so the previous file is intact if we crash while writing
+    QSaveFile f(m_fileName);
+    if (!f.open(QIODevice::WriteOnly)) {
+        qWarning() << Q_FUNC_INFO << "Failed to open" << m_fileName << f.errorString();
+        return false;
+    }
+
+    if (f.write(data) != data.size() || !f.commit()) {
+        qWarning() << Q_FUNC_INFO << "Failed to write" << m_fileName << f.errorString();
+        return false;
+    }
+
+    // The new file already contains everything the journal had. If we crash before removing it,
+    // its entries are ignored, as they have an older generation.
+    m_generation = generation;
+    const QString journalName = journalFileName(m_fileName);
+    if (QFile::exists(journalName) && !QFile::remove(journalName)) {
+        qWarning() << Q_FUNC_INFO << "Failed to remove" << journalName;
+        return false;
+    }
+
+    m_fileSize = data.size();
+    m_journalSize = 0;
+    m_numJournalEntries = 0;
+
+    return true;
+}
+
+bool LayoutAutoSaver::Private::appendToJournal(const QJsonObject &entry)
+{
+    QJsonObject entryWithGeneration = entry;
+    entryWithGeneration.insert(generationKey(), double(m_generation));
+    const QByteArray line = QJsonDocument(entryWithGeneration).toJson(QJsonDocument::Compact) + '\n';
+
+    QFile journal(journalFileName(m_fileName));
+    if (!journal.open(QIODevice::WriteOnly | QIODevice::Append)) {
+        qWarning() << Q_FUNC_INFO << "Failed to open" << journal.fileName() << journal.errorString();
+        return false;
+    }
+
+    if (journal.write(line) != line.size() || !syncToDisk(journal)) {
+        qWarning() << Q_FUNC_INFO << "Failed to write" << journal.fileName() << journal.errorString();
+        return false;
+    }
+
+    m_journalSize += line.size();
+    m_numJournalEntries++;
+
+    return true;
+}
@@ -0,0 +1,139 @@
+/*
+  This file is part of KDDockWidgets.
+
+  SPDX-FileCopyrightText: 2019-2020 Klarälvdalens Datakonsult AB, a KDAB Group company <info@kdab.com>
+  Author: Sérgio Martins <sergio.martins@kdab.com>
+
+  SPDX-License-Identifier: GPL-2.0-only OR GPL-3.0-only
+
+  Contact KDAB at <info@kdab.com> for commercial licensing options.
+*/
+
+/**
+ * @file
+ * @brief Class to periodically save the layout to disk, for crash recovery.
+ *
+ * @author Sérgio Martins \<sergio.martins@kdab.com\>
+ */
+
+#ifndef KD_LAYOUTAUTOSAVER_H
+#define KD_LAYOUTAUTOSAVER_H
+
+#include "docks_export.h"
+
+#include <QObject>
+
+QT_BEGIN_NAMESPACE
+class QByteArray;
+QT_END_NAMESPACE
+
+namespace KDDockWidgets {
+
+/**
+ * @brief Saves the layout to a file periodically, without blocking the GUI thread.
+ *
+ * The GUI thread only takes a snapshot of the layout (the same structs @ref LayoutSaver uses).
+ * JSON encoding, the atomic file replacement and the fsync happen on a worker thread.
+ * If a save is requested while the previous one is still being written, only the newest snapshot
+ * is written.
+ *
+ * When journaling is enabled, only the top-level sections of the layout that changed since the
+ * last write are appended to a journal file (see @ref journalFileName()). The journal is compacted
+ * into the main file every @ref journalCompactionThreshold() entries.
+ *
+ * To restore, pass @ref recoveredLayout() to @ref LayoutSaver::restoreLayout(), which
+ * also takes any pending journal entries into account.
+ *
+ * Example:
+ * @code
+ * auto autoSaver = new KDDockWidgets::LayoutAutoSaver(QStringLiteral("recovery.json"), this);
+ * autoSaver->setJournalingEnabled(true);
+ * autoSaver->start();
+ * (...)
+ * KDDockWidgets::LayoutSaver saver;
+ * saver.restoreLayout(KDDockWidgets::LayoutAutoSaver::recoveredLayout(QStringLiteral("recovery.json")));
+ * @endcode
+ */
+class DOCKS_EXPORT LayoutAutoSaver : public QObject
+{
+    Q_OBJECT
+public:
+    ///@brief Constructor.
+    ///@param fileName the file where the layout will be saved to
+    explicit LayoutAutoSaver(const QString &fileName, QObject *parent = nullptr);
+
+    ///@brief Destructor. Waits for any save that's still being written.
+    ~LayoutAutoSaver() override;
+
+    ///@brief returns the file name passed in the constructor
+    QString fileName() const;
+
+    ///@brief Sets the interval in milliseconds between automatic saves. Default is 30 seconds.
+    void setInterval(int msecs);
+
+    ///@brief returns the interval in milliseconds between automatic saves
+    int interval() const;
+
+    ///@brief Starts saving periodically
+    void start();
+
+    ///@brief Stops saving periodically. Saves that were already requested are still written.
+    void stop();
+
+    ///@brief returns whether periodic saving is active
+    bool isActive() const;
+
+    ///@brief See @ref LayoutSaver::setAffinityNames()
+    void setAffinityNames(const QStringList &affinityNames);
+
+    ///@brief Enables appending only what changed to a journal file instead of rewriting the whole file.
+    ///Disabled by default.
+    void setJournalingEnabled(bool);
+
+    ///@brief returns whether journaling is enabled
+    bool journalingEnabled() const;
+
+    ///@brief Sets after how many journal entries the journal is merged into the main file.
+    ///Default is 20.
+    void setJournalCompactionThreshold(int numEntries);
+
+    ///@brief returns after how many journal entries the journal is merged into the main file
+    int journalCompactionThreshold() const;
+
+    /**
+     * @brief Takes a snapshot of the current layout and schedules writing it.
+     *
+     * Returns immediately, the file is written on a worker thread and @ref saved() is emitted
+     * when done.
+     *
+     * @return false if no snapshot could be taken, for example while restoring a layout.
+     */
+    bool saveNow();
+
+    ///@brief Blocks until all scheduled saves have been written.
+    void waitForPendingSaves();
+
+    ///@brief returns the name of the journal file which is used for @p fileName
+    static QString journalFileName(const QString &fileName);
+
+    /**
+     * @brief Returns the layout saved to @p fileName, with its journal entries applied.
+     *
+     * The result can be passed to @ref LayoutSaver::restoreLayout().
+     * A journal entry that was only partially written, due to a crash, is ignored.
+     */
+    static QByteArray recoveredLayout(const QString &fileName);
+
+Q_SIGNALS:
+    ///@brief Emitted when a snapshot has been written to disk, or failed to.
+    ///Note that this signal is emitted from the worker thread.
+    void saved(bool success);
+
+private:
+    Q_DISABLE_COPY(LayoutAutoSaver)
+    class Private;
+    Private *const d;
+};
+}
+
+#endif
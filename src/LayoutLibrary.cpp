@@ -0,0 +1,405 @@
+/*
+  This file is part of KDDockWidgets.
+
+  SPDX-FileCopyrightText: 2019-2020 Klarälvdalens Datakonsult AB, a KDAB Group company <info@kdab.com>
+  Author: Sérgio Martins <sergio.martins@kdab.com>
+
+  SPDX-License-Identifier: GPL-2.0-only OR GPL-3.0-only
+
+  Contact KDAB at <info@kdab.com> for commercial licensing options.
+*/
+
+/**
+ * @file
+ * @brief Class to store many named layouts in a single file.
+ *
+ * @author Sérgio Martins \<sergio.martins@kdab.com\>
+ */
+
+#include "LayoutLibrary.h"
+#include "LayoutSaver.h"
+#include "LayoutSaver_p.h"
+
+#include <QDataStream>
+#include <QDebug>
+#include <QFile>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QSaveFile>
+
+#include <climits>
+
+using namespace KDDockWidgets;
+
+/**
+ * File format:
+ *   quint32 magic
+ *   quint32 library format version
+ *   quint32 number of presets
+ *   for each preset: QString name, qint32 serialization version, quint64 offset, quint64 size
+ *   preset data, at the offsets specified in the index
+ *
+ * Bump KDDW_LAYOUTLIBRARY_VERSION whenever the index format changes.
+ * The preset data itself is versioned by KDDOCKWIDGETS_SERIALIZATION_VERSION.
+ */
+#define KDDW_LAYOUTLIBRARY_MAGIC 0x4B44444C
+#define KDDW_LAYOUTLIBRARY_VERSION 1
+
+class LayoutLibrary::Private
+{
+public:
+    struct Entry
+    {
+        QString name;
+        qint32 serializationVersion = -1;
+        quint64 offset = 0;
+        quint64 size = 0;
+    };
+
+    explicit Private(const QString &fileName)
+        : m_file(fileName)
+    {
+    }
+
+    int indexOf(const QString &name) const;
+    QByteArray dataForEntry(const Entry &) const;
+    bool readIndex();
+    bool map();
+    void unmap();
+    bool canWrite() const;
+    bool write(const QVector<Entry> &entries, const QVector<QByteArray> &datas);
+    static void writeIndex(QDataStream &, const QVector<Entry> &);
+
+    QFile m_file;
+    uchar *m_mapped = nullptr;
+    qint64 m_mappedSize = 0;
+    QVector<Entry> m_entries;
+
+    // Set when the file couldn't be read. Writing would then replace it with only the new preset.
+    bool m_invalid = false;
+};
+
+LayoutLibrary::LayoutLibrary(const QString &fileName)
+    : d(new Private(fileName))
+{
+}
+
+LayoutLibrary::~LayoutLibrary()
+{
+    close();
+    delete d;
+}
+
+QString LayoutLibrary::fileName() const
+{
+    return d->m_file.fileName();
+}
+
+bool LayoutLibrary::open()
+{
+    close();
+    d->m_invalid = false;
+
+    if (!d->m_file.exists())
+        return true;
+
+    if (!d->map()) {
+        qWarning() << Q_FUNC_INFO << "Invalid layout library" << d->m_file.fileName() << d->m_file.errorString();
+        close();
+        d->m_invalid = true;
+        return false;
+    }
+
+    return true;
+}
+
+void LayoutLibrary::close()
+{
+    d->unmap();
+    d->m_entries.clear();
+}
+
+QStringList LayoutLibrary::presetNames() const
+{
+    QStringList names;
+    names.reserve(d->m_entries.size());
+    for (const Private::Entry &entry : qAsConst(d->m_entries))
+        names.push_back(entry.name);
+
+    return names;
+}
+
+bool LayoutLibrary::contains(const QString &name) const
+{
+    return d->indexOf(name) != -1;
+}
+
+int LayoutLibrary::presetSerializationVersion(const QString &name) const
+{
+    const int index = d->indexOf(name);
+    return index == -1 ? -1 : d->m_entries.at(index).serializationVersion;
+}
+
+QByteArray LayoutLibrary::presetData(const QString &name) const
+{
+    const int index = d->indexOf(name);
+    return index == -1 ? QByteArray() : d->dataForEntry(d->m_entries.at(index));
+}
+
+bool LayoutLibrary::setPresetData(const QString &name, const QByteArray &layoutData)
+{
+    if (!d->canWrite())
+        return false;
+
+    if (name.isEmpty()) {
+        qWarning() << Q_FUNC_INFO << "Preset name can't be empty";
+        return false;
+    }
+
+    QJsonParseError error;
+    const QJsonDocument doc = QJsonDocument::fromJson(layoutData, &error);
+    if (error.error != QJsonParseError::NoError) {
+        qWarning() << Q_FUNC_INFO << "Refusing to store invalid layout" << name << error.errorString();
+        return false;
+    }
+
+    Private::Entry newEntry;
+    newEntry.name = name;
+    newEntry.serializationVersion = doc.object().value(QStringLiteral("serializationVersion")).toInt();
+
+    // Unchanged presets are written straight from the mapping
+    QVector<Private::Entry> entries;
+    QVector<QByteArray> datas;
+    entries.reserve(d->m_entries.size() + 1);
+    datas.reserve(d->m_entries.size() + 1);
+    bool replaced = false;
+    for (const Private::Entry &entry : qAsConst(d->m_entries)) {
+        if (entry.name == name) {
+            entries.push_back(newEntry);
+            datas.push_back(layoutData);
+            replaced = true;
+        } else {
+            entries.push_back(entry);
+            datas.push_back(d->dataForEntry(entry));
+        }
+    }
+
+    if (!replaced) {
+        entries.push_back(newEntry);
+        datas.push_back(layoutData);
+    }
+
+    return d->write(entries, datas);
+}
+
+bool LayoutLibrary::savePreset(const QString &name)
+{
+    LayoutSaver saver;
+    const QByteArray data = saver.serializeLayout();
+    if (data.isEmpty())
+        return false;
+
+    return setPresetData(name, data);
+}
+
+bool LayoutLibrary::removePreset(const QString &name)
+{
+    if (!d->canWrite())
+        return false;
+
+    const int index = d->indexOf(name);
+    if (index == -1)
+        return false;
+
+    QVector<Private::Entry> entries;
+    QVector<QByteArray> datas;
+    entries.reserve(d->m_entries.size());
+    datas.reserve(d->m_entries.size());
+    for (int i = 0; i < d->m_entries.size(); ++i) {
+        if (i != index) {
+            entries.push_back(d->m_entries.at(i));
+            datas.push_back(d->dataForEntry(d->m_entries.at(i)));
+        }
+    }
+
+    return d->write(entries, datas);
+}
+
+bool LayoutLibrary::restorePreset(const QString &name, RestoreOptions options)
+{
+    const int index = d->indexOf(name);
+    if (index == -1) {
+        qWarning() << Q_FUNC_INFO << "Couldn't find preset" << name;
+        return false;
+    }
+
+    const Private::Entry &entry = d->m_entries.at(index);
+    if (entry.serializationVersion != KDDOCKWIDGETS_SERIALIZATION_VERSION) {
+        qWarning() << Q_FUNC_INFO << "Serialization format is too old"
+                   << entry.serializationVersion << "current=" << KDDOCKWIDGETS_SERIALIZATION_VERSION;
+        return false;
+    }
+
+    LayoutSaver saver(options);
+    return saver.restoreLayout(d->dataForEntry(entry));
+}
+
+int LayoutLibrary::Private::indexOf(const QString &name) const
+{
+    for (int i = 0; i < m_entries.size(); ++i) {
+        if (m_entries.at(i).name == name)
+            return i;
+    }
+
+    return -1;
+}
+
+QByteArray LayoutLibrary::Private::dataForEntry(const Entry &entry) const
+{
+    return QByteArray::fromRawData(reinterpret_cast<const char *>(m_mapped + entry.offset), int(entry.size));
+}
+
+bool LayoutLibrary::Private::readIndex()
+{
+    // The index is at the start, that's all the stream needs to see
+    const int indexSizeLimit = int(qMin(m_mappedSize, qint64(INT_MAX)));
+    QDataStream ds(QByteArray::fromRawData(reinterpret_cast<const char *>(m_mapped), indexSizeLimit));
+    ds.setVersion(QDataStream::Qt_5_9);
+
+    quint32 magic = 0;
+    quint32 version = 0;
+    quint32 count = 0;
+    ds >> magic >> version >> count;
+    if (magic != KDDW_LAYOUTLIBRARY_MAGIC || version != KDDW_LAYOUTLIBRARY_VERSION)
+        return false;
+
+    // Don't trust count for reserving, the file might be corrupt
+    m_entries.clear();
+    const quint64 mappedSize = quint64(m_mappedSize);
+    for (quint32 i = 0; i < count; ++i) {
+        Entry entry;
+        ds >> entry.name >> entry.serializationVersion >> entry.offset >> entry.size;
+        if (ds.status() != QDataStream::Ok)
+            return false;
+
+        // Written so it can't overflow, and so dataForEntry() can use an int size
+        if (entry.offset > mappedSize || entry.size > mappedSize - entry.offset || entry.size > quint64(INT_MAX))
+            return false;
+
+        m_entries.push_back(entry);
+    }
+
+    return true;
+}
+
+bool LayoutLibrary::Private::map()
+{
+    if (!m_file.open(QIODevice::ReadOnly))
+        return false;
+
+    m_mappedSize = m_file.size();
+    if (m_mappedSize > 0)
+        m_mapped = m_file.map(0, m_mappedSize);
+
+    if (!m_mapped || !readIndex()) {
+        unmap();
+        return false;
+    }
+
+    return true;
+}
+
+void LayoutLibrary::Private::unmap()
+{
+    if (m_mapped)
+        m_file.unmap(m_mapped);
+
+    m_mapped = nullptr;
+    m_mappedSize = 0;
+    m_file.close();
+}
+
+bool LayoutLibrary::Private::canWrite() const
+{
+    if (m_invalid) {
+        qWarning() << Q_FUNC_INFO << "Refusing to modify unreadable layout library" << m_file.fileName();
+        return false;
+    }
+
+    return true;
+}
+
+void LayoutLibrary::Private::writeIndex(QDataStream &ds, const QVector<Entry> &entries)
+{
+    ds << quint32(KDDW_LAYOUTLIBRARY_MAGIC) << quint32(KDDW_LAYOUTLIBRARY_VERSION) << quint32(entries.size());
+    for (const Entry &entry : entries)
+        ds << entry.name << entry.serializationVersion << entry.offset << entry.size;
+}
+
+bool LayoutLibrary::Private::write(const QVector<Entry> &entries, const QVector<QByteArray> &datas)
+{
+    // Names vary in length, but offsets and sizes are fixed-width, so the index size doesn't depend
+    // on their values. Serialize it once to learn its size, then again with the real offsets.
+    QByteArray index;
+    {
+        QDataStream ds(&index, QIODevice::WriteOnly);
+        ds.setVersion(QDataStream::Qt_5_9);
+        writeIndex(ds, entries);
+    }
+
+    QVector<Entry> newEntries = entries;
+    quint64 offset = quint64(index.size());
+    for (int i = 0; i < newEntries.size(); ++i) {
+        newEntries[i].offset = offset;
+        newEntries[i].size = quint64(datas.at(i).size());
+        offset += newEntries[i].size;
+    }
+
+    index.clear();
+    {
+        QDataStream ds(&index, QIODevice::WriteOnly);
+        ds.setVersion(QDataStream::Qt_5_9);
+        writeIndex(ds, newEntries);
+    }
+
+    QSaveFile f(m_file.fileName());
+    if (!f.open(QIODevice::WriteOnly)) {
+        qWarning() << Q_FUNC_INFO << "Failed to open" << m_file.fileName() << f.errorString();
+        return false;
+    }
+
+    bool success = f.write(index) == index.size();
+    for (const QByteArray &data : datas)
+        success = success && f.write(data) == data.size();
+
+    if (!success) {
+        qWarning() << Q_FUNC_INFO << "Failed to write" << m_file.fileName() << f.errorString();
+        return false;
+    }
+
+    // The old mapping and index stay in use until the new file is in place. Replacing the file
+    // doesn't invalidate an existing mapping, except on Windows, which can't replace a mapped file.
+#ifdef Q_OS_WIN
+    unmap();
+#endif
+
+    if (!f.commit()) {
+        qWarning() << Q_FUNC_INFO << "Failed to write" << m_file.fileName() << f.errorString();
+        if (!m_mapped && !m_entries.isEmpty() && !map()) {
+            // The old file is still there, but we can't read it anymore
+            m_entries.clear();
+            m_invalid = true;
+        }
+        return false;
+    }
+
+    unmap();
+    if (!map()) {
+        qWarning() << Q_FUNC_INFO << "Failed to map" << m_file.fileName() << m_file.errorString();
+        m_entries.clear();
+        m_invalid = true;
+        return false;
+    }
+
+    return true;
+}
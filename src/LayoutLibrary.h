@@ -0,0 +1,123 @@
+/*
+  This file is part of KDDockWidgets.
+
+  SPDX-FileCopyrightText: 2019-2020 Klarälvdalens Datakonsult AB, a KDAB Group company <info@kdab.com>
+  Author: Sérgio Martins <sergio.martins@kdab.com>
+
+  SPDX-License-Identifier: GPL-2.0-only OR GPL-3.0-only
+
+  Contact KDAB at <info@kdab.com> for commercial licensing options.
+*/
+
+/**
+ * @file
+ * @brief Class to store many named layouts in a single file.
+ *
+ * @author Sérgio Martins \<sergio.martins@kdab.com\>
+ */
+
+#ifndef KD_LAYOUTLIBRARY_H
+#define KD_LAYOUTLIBRARY_H
+
+#include "docks_export.h"
+
+#include "KDDockWidgets.h"
+
+QT_BEGIN_NAMESPACE
+class QByteArray;
+QT_END_NAMESPACE
+
+namespace KDDockWidgets {
+
+/**
+ * @brief Stores many named layouts (presets) in a single file.
+ *
+ * The file starts with an index containing the name, serialization version, offset and size
+ * of each preset, followed by the presets themselves, in the same format that
+ * @ref LayoutSaver::serializeLayout() produces.
+ *
+ * The file is memory mapped, so listing the presets only reads the index and loading a preset
+ * only touches its own bytes.
+ *
+ * Example:
+ * @code
+ * KDDockWidgets::LayoutLibrary library(QStringLiteral("presets.kddl"));
+ * library.open();
+ * library.savePreset(QStringLiteral("Trading"));
+ * (...)
+ * library.restorePreset(QStringLiteral("Trading"));
+ * @endcode
+ */
+class DOCKS_EXPORT LayoutLibrary
+{
+public:
+    ///@brief Constructor. Call @ref open() before using the library.
+    explicit LayoutLibrary(const QString &fileName);
+
+    ///@brief Destructor.
+    ~LayoutLibrary();
+
+    ///@brief returns the file name passed in the constructor
+    QString fileName() const;
+
+    /**
+     * @brief Maps the file and reads its index.
+     * A file which doesn't exist yet is treated as an empty library.
+     * @return false if the file exists but isn't a valid layout library
+     */
+    bool open();
+
+    ///@brief Unmaps the file. Any QByteArray returned by @ref presetData() becomes invalid.
+    void close();
+
+    ///@brief returns the names of all presets, in the order they were added
+    QStringList presetNames() const;
+
+    ///@brief returns whether there's a preset called @p name
+    bool contains(const QString &name) const;
+
+    ///@brief returns the serialization version the preset was saved with, or -1 if there's no such preset
+    int presetSerializationVersion(const QString &name) const;
+
+    /**
+     * @brief returns the saved layout of the preset called @p name
+     *
+     * The returned QByteArray points directly into the mapped file and doesn't copy it.
+     * It's only valid until the library is modified, closed or destroyed.
+     */
+    QByteArray presetData(const QString &name) const;
+
+    /**
+     * @brief Stores @p layoutData, as returned by @ref LayoutSaver::serializeLayout(), as preset
+     * @p name, replacing any existing preset with the same name.
+     *
+     * The file is rewritten atomically.
+     * @return true on success
+     */
+    bool setPresetData(const QString &name, const QByteArray &layoutData);
+
+    ///@brief Saves the current layout as preset @p name. Convenience overload for @ref setPresetData()
+    bool savePreset(const QString &name);
+
+    ///@brief removes the preset called @p name. The file is rewritten atomically.
+    bool removePreset(const QString &name);
+
+    /**
+     * @brief Restores the preset called @p name.
+     *
+     * Presets saved with an unsupported serialization version are rejected without reading them.
+     * Use @ref presetData() and @ref LayoutSaver::restoreLayout() directly if you need to pass
+     * affinity names.
+     *
+     * @return true on success
+     */
+    bool restorePreset(const QString &name, RestoreOptions options = RestoreOption_None);
+
+private:
+    Q_DISABLE_COPY(LayoutLibrary)
+    class Private;
+    Private *const d;
+};
+}
+
+#endif
@@ -144,14 +144,21 @@ bool LayoutSaver::restoreFromFile(const QString &jsonFilename)
 }
 
 QByteArray LayoutSaver::serializeLayout() const
+{
+    LayoutSaver::Layout layout;
+    if (!serializeLayout(layout))
+        return {};
+
+    return layout.toJson();
+}
+
+bool LayoutSaver::serializeLayout(LayoutSaver::Layout &layout) const
 {
     if (!d->m_dockRegistry->isSane()) {
         qWarning() << Q_FUNC_INFO << "Refusing to serialize this layout. Check previous warnings.";
-        return {};
+        return false;
     }
 
-    LayoutSaver::Layout layout;
-
     // Just a simplification. One less type of windows to handle.
     d->m_dockRegistry->ensureAllFloatingWidgetsAreMorphed();
 
@@ -190,7 +197,7 @@ QByteArray LayoutSaver::serializeLayout() const
         }
     }
 
-    return layout.toJson();
+    return true;
 }
 
 bool LayoutSaver::restoreLayout(const QByteArray &data)
@@ -503,8 +510,8 @@ bool LayoutSaver::Frame::isValid() const
         return false;
     }
 
-    if (id.isEmpty()) {
-        qWarning() << Q_FUNC_INFO << "Invalid id";
+    if (id <= 0) {
+        qWarning() << Q_FUNC_INFO << "Invalid id" << id;
         return false;
     }
 
@@ -556,7 +563,8 @@ void LayoutSaver::Frame::fromVariantMap(const QVariantMap &map)
         return;
     }
 
-    id = map.value(QStringLiteral("id")).toString();
+    // Layouts saved by older versions have the id as a string, toLongLong() handles both
+    id = map.value(QStringLiteral("id")).toLongLong();
     isNull = map.value(QStringLiteral("isNull")).toBool();
     objectName = map.value(QStringLiteral("objectName")).toString();
     geometry = Layouting::mapToRect(map.value(QStringLiteral("geometry")).toMap());
@@ -761,7 +769,7 @@ QVariantMap LayoutSaver::MultiSplitter::toVariantMap() const
 
     QVariantMap framesV;
     for (auto &frame : frames)
-        framesV.insert(frame.id, frame.toVariantMap());
+        framesV.insert(QString::number(frame.id), frame.toVariantMap());
 
     result.insert(QStringLiteral("frames"), framesV);
     return result;
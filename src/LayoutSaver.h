@@ -108,6 +108,11 @@ public:
 private:
     Q_DISABLE_COPY(LayoutSaver)
     friend class ::TestDocks;
+    friend class LayoutAutoSaver;
+
+    ///@brief Fills @p layout with the current state, without encoding it.
+    ///Returns false if the layout can't be saved. Used by @ref serializeLayout().
+    bool serializeLayout(LayoutSaver::Layout &layout) const;
 
     class Private;
     Private *const d;
@@ -184,7 +184,7 @@ struct LayoutSaver::Frame
     QRect geometry;
     unsigned int options;
     int currentTabIndex;
-    QString id; // for coorelation purposes
+    qint64 id = 0; // for coorelation purposes
 
     LayoutSaver::DockWidget::List dockWidgets;
 };
@@ -199,7 +199,7 @@ struct LayoutSaver::MultiSplitter
     void fromVariantMap(const QVariantMap &map);
 
     QVariantMap layout;
-    QHash<QString, LayoutSaver::Frame> frames;
+    QHash<qint64, LayoutSaver::Frame> frames;
 };
 
 struct LayoutSaver::FloatingWindow
@@ -26,6 +26,14 @@
 #include "Logging_p.h"
 #include "FrameworkWidgetFactory.h"
 #include "DropAreaWithCentralFrame_p.h"
+#include "Config.h"
+
+#include <QTimer>
+
+#ifdef KDDOCKWIDGETS_QTWIDGETS
+# include <QLabel>
+# include <QPixmap>
+#endif
 
 using namespace KDDockWidgets;
 
@@ -37,6 +45,16 @@ public:
         , q(mainWindow)
         , m_dropArea(new DropAreaWithCentralFrame(mainWindow, options))
     {
+        m_compactionTimer.setSingleShot(true);
+        QObject::connect(&m_compactionTimer, &QTimer::timeout, q, [this] {
+            q->compactLayout();
+            scheduleCompaction();
+        });
+
+        // The DropArea outlives us, it's deleted by ~QWidget, so use a context we own
+        QObject::connect(m_dropArea, &MultiSplitter::visibleWidgetCountChanged, &m_compactionTimer, [this] {
+            scheduleCompaction();
+        });
     }
 
     bool supportsCentralFrame() const
@@ -48,13 +66,30 @@ public:
     SideBarLocation preferredSideBar(DockWidgetBase *) const;
     void updateOverlayGeometry();
     void clearSideBars();
+    void scheduleCompaction();
+    Frame *overlayFrame();
+    void onOverlayFrameCountChanged();
+#ifdef KDDOCKWIDGETS_QTWIDGETS
+    void takeOverlaySnapshot(DockWidgetBase *);
+    void showOverlaySnapshot(DockWidgetBase *);
+    void dropOverlaySnapshot();
+#endif
 
     QString name;
     QStringList affinities;
     const MainWindowOptions m_options;
     MainWindowBase *const q;
     QPointer<DockWidgetBase> m_overlayedDockWidget;
+    QPointer<Frame> m_overlayFrame;
+#ifdef KDDOCKWIDGETS_QTWIDGETS
+    // Only the dock widget of the last dismissed overlay is remembered, and only gets a snapshot
+    // once it's dismissed a second time in a row, as only then it's likely to be shown again
+    QPointer<DockWidgetBase> m_lastOverlayedDockWidget;
+    QPixmap m_overlaySnapshot;
+    QPointer<QLabel> m_overlaySnapshotLabel;
+#endif
     DropAreaWithCentralFrame *const m_dropArea;
+    QTimer m_compactionTimer;
 };
 
 MainWindowBase::MainWindowBase(const QString &uniqueName, KDDockWidgets::MainWindowOptions options,
@@ -157,6 +192,27 @@ void MainWindowBase::layoutParentContainerEqually(DockWidgetBase *dockWidget)
     dropArea()->layoutParentContainerEqually(dockWidget);
 }
 
+int MainWindowBase::compactLayout()
+{
+    return dropArea()->compactPlaceholders();
+}
+
+void MainWindowBase::Private::scheduleCompaction()
+{
+    const int maxCount = Config::self().maxPlaceholderCount();
+    const int maxAge = Config::self().maxPlaceholderAge();
+    if (maxCount == 0 && maxAge == 0)
+        return;
+
+    const int placeholderCount = m_dropArea->placeholderCount();
+    if (maxCount > 0 && placeholderCount > maxCount) {
+        m_compactionTimer.start(0);
+    } else if (maxAge > 0 && placeholderCount > 0 && !m_compactionTimer.isActive()) {
+        // Re-armed after each compaction, so expired placeholders are removed within 2 * maxAge
+        m_compactionTimer.start(maxAge);
+    }
+}
+
 QRect MainWindowBase::Private::rectForOverlay(Frame *frame, SideBarLocation location) const
 {
     SideBar *sb = q->sideBar(location);
@@ -337,6 +393,87 @@ void MainWindowBase::Private::updateOverlayGeometry()
     m_overlayedDockWidget->frame()->QWidgetAdapter::setGeometry(rectForOverlay(m_overlayedDockWidget->frame(), sb->location()));
 }
 
+Frame *MainWindowBase::Private::overlayFrame()
+{
+    // Kept hidden between overlays, instead of creating a Frame each time a side bar button is clicked
+    if (!m_overlayFrame) {
+        m_overlayFrame = Config::self().frameworkWidgetFactory()->createFrame(q, FrameOption_IsOverlayed);
+        QObject::connect(m_overlayFrame, &Frame::numDockWidgetsChanged, q, [this] {
+            onOverlayFrameCountChanged();
+        });
+    }
+
+    return m_overlayFrame;
+}
+
+void MainWindowBase::Private::onOverlayFrameCountChanged()
+{
+    if (!m_overlayFrame || !m_overlayFrame->isEmpty())
+        return;
+
+    m_overlayFrame->QWidgetAdapter::hide();
+
+    // The dock widget might have left without clearSideBarOverlay(), for example by being closed
+    if (DockWidgetBase *dw = m_overlayedDockWidget) {
+        m_overlayedDockWidget = nullptr;
+        Q_EMIT dw->isOverlayedChanged(false);
+    }
+}
+
+#ifdef KDDOCKWIDGETS_QTWIDGETS
+void MainWindowBase::Private::takeOverlaySnapshot(DockWidgetBase *dw)
+{
+    if (!m_overlayFrame || !m_overlayFrame->QWidgetAdapter::isVisible())
+        return;
+
+    if (m_overlaySnapshotLabel)
+        m_overlaySnapshotLabel->hide();
+
+    if (m_lastOverlayedDockWidget != dw) {
+        // grab() paints the whole frame again, don't pay for it if it's not shown repeatedly
+        dropOverlaySnapshot();
+        m_lastOverlayedDockWidget = dw;
+        return;
+    }
+
+    m_overlaySnapshot = m_overlayFrame->QWidgetAdapter::grab();
+}
+
+void MainWindowBase::Private::showOverlaySnapshot(DockWidgetBase *dw)
+{
+    const QPixmap snapshot = m_overlaySnapshot;
+    if (snapshot.isNull() || dw != m_lastOverlayedDockWidget)
+        return;
+
+    // If the main window was resized meanwhile the snapshot would show stretched, just show the live widget
+    const QSize snapshotSize = (QSizeF(snapshot.size()) / snapshot.devicePixelRatio()).toSize();
+    if (snapshotSize != m_overlayFrame->QWidgetAdapter::size())
+        return;
+
+    if (!m_overlaySnapshotLabel) {
+        m_overlaySnapshotLabel = new QLabel(m_overlayFrame);
+        m_overlaySnapshotLabel->setObjectName(QStringLiteral("_docks_OverlaySnapshot"));
+        m_overlaySnapshotLabel->setAutoFillBackground(true);
+    }
+
+    // Covers the frame for the first paint, so the guest doesn't need to be laid out and painted
+    // before the overlay appears. Swapped for the live widget in the next event loop iteration.
+    m_overlaySnapshotLabel->setPixmap(snapshot);
+    m_overlaySnapshotLabel->setGeometry(m_overlayFrame->QWidgetAdapter::rect());
+    m_overlaySnapshotLabel->raise();
+    m_overlaySnapshotLabel->show();
+    QTimer::singleShot(0, m_overlaySnapshotLabel.data(), &QWidget::hide);
+}
+
+void MainWindowBase::Private::dropOverlaySnapshot()
+{
+    m_lastOverlayedDockWidget = nullptr;
+    m_overlaySnapshot = QPixmap();
+    if (m_overlaySnapshotLabel)
+        m_overlaySnapshotLabel->clear();
+}
+#endif
+
 void MainWindowBase::Private::clearSideBars()
 {
     for (auto loc : { SideBarLocation::North, SideBarLocation::South,
@@ -368,6 +505,11 @@ void MainWindowBase::restoreFromSideBar(DockWidgetBase *dw)
     if (dw == d->m_overlayedDockWidget)
         clearSideBarOverlay();
 
+#ifdef KDDOCKWIDGETS_QTWIDGETS
+    if (dw == d->m_lastOverlayedDockWidget)
+        d->dropOverlaySnapshot();
+#endif
+
     SideBar *sb = sideBarForDockWidget(dw);
     if (!sb) {
         // Doesn't happen
@@ -398,10 +540,13 @@ void MainWindowBase::overlayOnSideBar(DockWidgetBase *dw)
     // We only support one overlay at a time, remove any existing overlay
     clearSideBarOverlay();
 
-    auto frame = Config::self().frameworkWidgetFactory()->createFrame(this, FrameOption_IsOverlayed);
+    Frame *frame = d->overlayFrame();
     d->m_overlayedDockWidget = dw;
     frame->addWidget(dw);
     d->updateOverlayGeometry();
+#ifdef KDDOCKWIDGETS_QTWIDGETS
+    d->showOverlaySnapshot(dw);
+#endif
     frame->QWidgetAdapter::show();
 
     Q_EMIT dw->isOverlayedChanged(true);
@@ -421,11 +566,16 @@ void MainWindowBase::clearSideBarOverlay()
     if (!d->m_overlayedDockWidget)
         return;
 
-    Frame *frame = d->m_overlayedDockWidget->frame();
-    d->m_overlayedDockWidget->setParent(nullptr);
-    Q_EMIT d->m_overlayedDockWidget->isOverlayedChanged(false);
+    DockWidgetBase *dw = d->m_overlayedDockWidget;
     d->m_overlayedDockWidget = nullptr;
-    delete frame;
+
+#ifdef KDDOCKWIDGETS_QTWIDGETS
+    d->takeOverlaySnapshot(dw);
+#endif
+
+    // The overlay frame becomes empty and is hidden, until the next overlay
+    dw->setParent(nullptr);
+    Q_EMIT dw->isOverlayedChanged(false);
 }
 
 SideBar *MainWindowBase::sideBarForDockWidget(const DockWidgetBase *dw) const
@@ -485,6 +635,11 @@ void MainWindowBase::onResized(QResizeEvent *)
 {
     if (d->m_overlayedDockWidget)
         d->updateOverlayGeometry();
+
+#ifdef KDDOCKWIDGETS_QTWIDGETS
+    // The snapshot would have the wrong size now
+    d->dropOverlaySnapshot();
+#endif
 }
 
 bool MainWindowBase::deserialize(const LayoutSaver::MainWindow &mw)
@@ -135,6 +135,15 @@ public:
     /// sub-tree.
     void layoutParentContainerEqually(DockWidgetBase *dockWidget);
 
+    /// @brief Removes the placeholders that closed dock widgets left in the layout, if they can't
+    /// be restored anymore or exceed Config::maxPlaceholderCount() or Config::maxPlaceholderAge().
+    /// Then removes any nesting that became redundant.
+    ///
+    /// This is done automatically if any of those Config limits is set. Long running applications
+    /// can also call it explicitly to keep the layout small.
+    /// @return the number of placeholders removed
+    int compactLayout();
+
     ///@brief Moves the dock widget into one of the MainWindow's sidebar.
     /// Means the dock widget is removed from the layout, and the sidebar shows a button that if pressed
     /// will toggle the dock widget's visibility as an overlay over the layout. This is the auto-hide
@@ -21,6 +21,8 @@
 #include "DockRegistry_p.h"
 #include "FloatingWindow_p.h"
 #include "DropArea_p.h"
+#include "Frame_p.h"
+#include "TitleBar_p.h"
 #include "MainWindow.h"
 #include "LayoutSaver.h"
 #include "Qt5Qt6Compat_p.h"
@@ -251,6 +253,18 @@ DebugWindow::DebugWindow(QWidget *parent)
         });
     });
 
+    button = new QPushButton(this);
+    button->setText(QStringLiteral("Dump coalesced title bar updates"));
+    layout->addWidget(button);
+    connect(button, &QPushButton::clicked, this, [] {
+        const auto frames = DockRegistry::self()->frames();
+        for (Frame *frame : frames) {
+            qDebug() << frame->title()
+                     << "; title and icon:" << frame->dbg_numCoalescedUpdates()
+                     << "; buttons:" << frame->titleBar()->dbg_numCoalescedUpdates();
+        }
+    });
+
 #ifdef Q_OS_WIN
     button = new QPushButton(this);
     button->setText(QStringLiteral("Dump native windows"));
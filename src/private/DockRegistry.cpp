@@ -14,19 +14,25 @@
 #include "Logging_p.h"
 #include "Position_p.h"
 #include "MultiSplitter_p.h"
+#include "Frame_p.h"
 #include "QWidgetAdapter.h"
 #include "Config.h"
 #include "SideBar_p.h"
 #include "WindowBeingDragged_p.h"
 #include "FloatingWindow_p.h"
+#include "../FocusScope.h"
 
 #include <QPointer>
 #include <QDebug>
+#include <QSet>
 #include <QGuiApplication>
 #include <QWindow>
 
+#include <algorithm>
+
 #ifdef KDDOCKWIDGETS_QTWIDGETS
 # include "DebugWindow_p.h"
+# include "EventRecorder_p.h"
 #else
 # include "quick/QmlTypes.h"
 #endif
@@ -56,6 +62,13 @@ DockRegistry::DockRegistry(QObject *parent)
     }
 # endif
 
+    // Owned by qApp, as DockRegistry is deleted whenever it becomes empty and recreated later.
+    // One recorder per session, otherwise the next one would overwrite the file.
+    static QPointer<Debug::EventRecorder> s_eventRecorder;
+    const QByteArray recordingFile = qgetenv("KDDOCKWIDGETS_RECORD_EVENTS");
+    if (!recordingFile.isEmpty() && !s_eventRecorder)
+        s_eventRecorder = new Debug::EventRecorder(QString::fromLocal8Bit(recordingFile), qApp);
+
 #else
     KDDockWidgets::registerQmlTypes();
     QQuickWindow::setDefaultAlphaBuffer(true);
@@ -64,6 +77,10 @@ DockRegistry::DockRegistry(QObject *parent)
     connect(qApp, &QGuiApplication::focusObjectChanged,
             this, &DockRegistry::onFocusObjectChanged);
 
+    m_sizeConstraintsTimer.setSingleShot(true);
+    m_sizeConstraintsTimer.setInterval(0);
+    connect(&m_sizeConstraintsTimer, &QTimer::timeout, this, &DockRegistry::updateSizeConstraints);
+
     initKDDockWidgetResources();
 }
 
@@ -73,22 +90,47 @@ DockRegistry::~DockRegistry()
 
 void DockRegistry::maybeDelete()
 {
-    if (isEmpty())
+    if (m_teardownDepth == 0 && isEmpty())
         delete this;
 }
 
 void DockRegistry::onFocusObjectChanged(QObject *obj)
 {
-    // In this function we reset the focused dock widget.
+    // In this function we reset the focused dock widget, and tell the focus scopes which gained
+    // or lost focus. Both only need a single walk through the focus object's parents.
+
+    bool isInDockWidget = false;
+    QVector<QObject*> focusedScopeWidgets;
 
     auto p = qobject_cast<WidgetType*>(obj);
     while (p) {
-        if (qobject_cast<DockWidgetBase*>(p) || qobject_cast<Frame*>(p))
-            return;
+        if (!isInDockWidget && (qobject_cast<DockWidgetBase*>(p) || qobject_cast<Frame*>(p)))
+            isInDockWidget = true;
+
+        if (m_focusScopes.contains(p))
+            focusedScopeWidgets.push_back(p);
+
         p = KDDockWidgets::Private::parentWidget(p);
     }
 
-    setFocusedDockWidget(nullptr);
+    if (!isInDockWidget)
+        setFocusedDockWidget(nullptr);
+
+    const QVector<QObject*> previouslyFocused = m_focusedScopeWidgets;
+    m_focusedScopeWidgets = focusedScopeWidgets;
+
+    // Looked up again each time, as the scopes emit signals, which can delete other scopes
+    for (QObject *widget : previouslyFocused) {
+        if (!focusedScopeWidgets.contains(widget)) {
+            if (FocusScope *scope = m_focusScopes.value(widget))
+                scope->onFocusObjectChanged(obj, false);
+        }
+    }
+
+    for (QObject *widget : qAsConst(focusedScopeWidgets)) {
+        if (FocusScope *scope = m_focusScopes.value(widget))
+            scope->onFocusObjectChanged(obj, true);
+    }
 }
 
 void DockRegistry::setFocusedDockWidget(DockWidgetBase *dw)
@@ -105,6 +147,15 @@ void DockRegistry::setFocusedDockWidget(DockWidgetBase *dw)
         Q_EMIT m_focusedDockWidget->isFocusedChanged(true);
 }
 
+qint64 DockRegistry::hibernatedBytes() const
+{
+    qint64 bytes = 0;
+    for (DockWidgetBase *dw : m_dockWidgets)
+        bytes += dw->hibernatedBytes();
+
+    return bytes;
+}
+
 bool DockRegistry::isEmpty(bool excludeBeingDeleted) const
 {
     if (!m_dockWidgets.isEmpty() || !m_mainWindows.isEmpty())
@@ -280,6 +331,9 @@ void DockRegistry::unregisterDockWidget(DockWidgetBase *dock)
     if (m_focusedDockWidget == dock)
         m_focusedDockWidget = nullptr;
 
+    if (m_teardownDepth > 0 && m_objectsBeingTornDown.remove(dock))
+        return; // Already unregistered by beginTeardown()
+
     m_dockWidgets.removeOne(dock);
     maybeDelete();
 }
@@ -312,6 +366,19 @@ void DockRegistry::unregisterFloatingWindow(FloatingWindow *window)
     maybeDelete();
 }
 
+void DockRegistry::registerFocusScope(FocusScope *scope, QObject *widget)
+{
+    m_focusScopes.insert(widget, scope);
+    if (scope->isFocused())
+        m_focusedScopeWidgets.push_back(widget);
+}
+
+void DockRegistry::unregisterFocusScope(QObject *widget)
+{
+    m_focusScopes.remove(widget);
+    m_focusedScopeWidgets.removeOne(widget);
+}
+
 void DockRegistry::registerLayout(MultiSplitter *layout)
 {
     m_layouts << layout;
@@ -329,9 +396,71 @@ void DockRegistry::registerFrame(Frame *frame)
 
 void DockRegistry::unregisterFrame(Frame *frame)
 {
+    if (m_teardownDepth > 0 && m_objectsBeingTornDown.remove(frame))
+        return; // Already unregistered by beginTeardown()
+
     m_frames.removeOne(frame);
 }
 
+void DockRegistry::beginTeardown(const Frame::List &frames)
+{
+    m_teardownDepth++;
+
+    for (Frame *frame : frames) {
+        m_objectsBeingTornDown.insert(frame);
+        const DockWidgetBase::List docks = frame->dockWidgets();
+        for (DockWidgetBase *dw : docks) {
+            m_objectsBeingTornDown.insert(dw);
+            if (m_focusedDockWidget == dw)
+                m_focusedDockWidget = nullptr;
+        }
+    }
+
+    auto isBeingTornDown = [this] (QObject *o) {
+        return m_objectsBeingTornDown.contains(o);
+    };
+
+    m_frames.erase(std::remove_if(m_frames.begin(), m_frames.end(), isBeingTornDown), m_frames.end());
+    m_dockWidgets.erase(std::remove_if(m_dockWidgets.begin(), m_dockWidgets.end(), isBeingTornDown), m_dockWidgets.end());
+}
+
+void DockRegistry::endTeardown()
+{
+    Q_ASSERT(m_teardownDepth > 0);
+    m_teardownDepth--;
+    if (m_teardownDepth > 0)
+        return;
+
+    // Anything that wasn't deleted, was reparented out in the meantime. Keep it registered.
+    for (QObject *o : qAsConst(m_objectsBeingTornDown)) {
+        if (auto frame = qobject_cast<Frame*>(o))
+            m_frames << frame;
+        else if (auto dw = qobject_cast<DockWidgetBase*>(o))
+            m_dockWidgets << dw;
+    }
+    m_objectsBeingTornDown.clear();
+
+    maybeDelete();
+}
+
+void DockRegistry::scheduleSizeConstraintsUpdate(Frame *frame)
+{
+    m_framesWithDirtySizeConstraints.push_back(frame);
+    if (!m_sizeConstraintsTimer.isActive())
+        m_sizeConstraintsTimer.start();
+}
+
+void DockRegistry::updateSizeConstraints()
+{
+    const QVector<QPointer<Frame>> frames = m_framesWithDirtySizeConstraints;
+    m_framesWithDirtySizeConstraints.clear();
+
+    for (Frame *frame : frames) {
+        if (frame) // Might have been deleted meanwhile
+            frame->updateSizeConstraints();
+    }
+}
+
 bool DockRegistry::containsDockWidget(const QString &uniqueName) const
 {
     return dockByName(uniqueName) != nullptr;
@@ -586,18 +715,47 @@ void DockRegistry::clear(const DockWidgetBase::List &dockWidgets,
                          const MainWindowBase::List &mainWindows,
                          const QStringList &affinities)
 {
+    QSet<DockWidgetBase *> docksToClose;
+    docksToClose.reserve(dockWidgets.size());
     for (auto dw : qAsConst(dockWidgets)) {
-        if (affinities.isEmpty() || affinitiesMatch(affinities, dw->affinities())) {
-            dw->forceClose();
-            dw->lastPositions().removePlaceholders();
-        }
+        if (affinities.isEmpty() || affinitiesMatch(affinities, dw->affinities()))
+            docksToClose.insert(dw);
     }
 
+    // Clear the layouts first. Otherwise closing each dock widget would make its neighbours grow,
+    // and relayout, right before being deleted too. Placeholders into these layouts go away with their Items.
     for (auto mw : qAsConst(mainWindows)) {
         if (affinities.isEmpty() || affinitiesMatch(affinities, mw->affinities())) {
             mw->multiSplitter()->clearLayout();
         }
     }
+
+    // Same for floating windows which would become empty
+    QVector<QPointer<FloatingWindow>> floatingWindowsToDelete;
+    for (FloatingWindow *fw : qAsConst(m_floatingWindows)) {
+        const DockWidgetBase::List docks = fw->dockWidgets();
+        const bool allClosing = std::all_of(docks.cbegin(), docks.cend(), [&docksToClose] (DockWidgetBase *dw) {
+            return docksToClose.contains(dw);
+        });
+
+        if (allClosing && !docks.isEmpty() && !fw->beingDeleted()) {
+            fw->dropArea()->clearLayout();
+            floatingWindowsToDelete.push_back(fw);
+        }
+    }
+
+    for (auto dw : qAsConst(dockWidgets)) {
+        if (docksToClose.contains(dw)) {
+            dw->forceClose();
+            dw->lastPositions().removePlaceholders();
+        }
+    }
+
+    // Their layout was cleared, so they didn't notice becoming empty
+    for (FloatingWindow *fw : qAsConst(floatingWindowsToDelete)) {
+        if (fw && !fw->beingDeleted())
+            fw->scheduleDeleteLater();
+    }
 }
 
 void DockRegistry::ensureAllFloatingWidgetsAreMorphed()
@@ -15,9 +15,12 @@
 #include "../DockWidgetBase.h"
 #include "../MainWindowBase.h"
 
+#include <QHash>
+#include <QSet>
 #include <QVector>
 #include <QObject>
 #include <QPointer>
+#include <QTimer>
 
 /**
  * DockRegistry is a singleton that knows about all DockWidgets.
@@ -28,6 +31,7 @@ namespace KDDockWidgets
 {
 
 class FloatingWindow;
+class FocusScope;
 class Frame;
 class SideBar;
 struct WindowBeingDragged;
@@ -53,8 +57,30 @@ public:
     void registerFrame(Frame *);
     void unregisterFrame(Frame *);
 
+    /**
+     * @brief Unregisters @p frames and their dock widgets in a single pass, as they're about to be deleted.
+     *
+     * Called by a layout being destroyed, so each destructor doesn't need to search the lists again.
+     * Must be followed by endTeardown() once they're deleted. Whatever survived is registered again.
+     */
+    void beginTeardown(const QList<Frame*> &frames);
+    void endTeardown();
+
+    ///@brief Called by Frame when its size constraints might have changed.
+    /// All frames scheduled during an event loop iteration are propagated to their layouts in a single pass.
+    void scheduleSizeConstraintsUpdate(Frame *);
+
+    ///@brief Called by FocusScope, so it gets notified when it gains or loses focus
+    ///@param widget the FocusScope's widget
+    void registerFocusScope(FocusScope *, QObject *widget);
+    void unregisterFocusScope(QObject *widget);
+
     DockWidgetBase *focusedDockWidget() const;
 
+    ///@brief Returns the memory currently released by hibernated dock widgets
+    ///@sa DockWidgetBase::setHibernation()
+    qint64 hibernatedBytes() const;
+
     bool containsDockWidget(const QString &uniqueName) const;
     DockWidgetBase *dockByName(const QString &) const;
     MainWindowBase *mainWindowByName(const QString &) const;
@@ -129,6 +155,10 @@ public:
 
     /**
      * @brief clear Overload that only clears the specified dockWidgets and main windows.
+     *
+     * The layouts of the main windows, and of floating windows only holding dock widgets being
+     * closed, are cleared before closing the dock widgets. So each close doesn't relayout what's
+     * going to be deleted anyway.
      */
     void clear(const DockWidgetBase::List &dockWidgets,
                const MainWindowBase::List &mainWindows,
@@ -213,6 +243,7 @@ private:
     void onFocusObjectChanged(QObject *obj);
     void maybeDelete();
     void setFocusedDockWidget(DockWidgetBase *);
+    void updateSizeConstraints();
 
     bool m_isProcessingAppQuitEvent = false;
     DockWidgetBase::List m_dockWidgets;
@@ -221,6 +252,18 @@ private:
     QVector<FloatingWindow*> m_floatingWindows;
     QVector<MultiSplitter*> m_layouts;
     QPointer<DockWidgetBase> m_focusedDockWidget;
+
+    // Frames and dock widgets already unregistered by beginTeardown(), which haven't been deleted yet
+    QSet<QObject*> m_objectsBeingTornDown;
+    int m_teardownDepth = 0;
+
+    // FocusScopes indexed by their widget, and the widgets of the ones containing the focus object,
+    // so a focus change only walks the focus object's parents once, instead of once per scope
+    QHash<QObject*, FocusScope*> m_focusScopes;
+    QVector<QObject*> m_focusedScopeWidgets;
+
+    QVector<QPointer<Frame>> m_framesWithDirtySizeConstraints;
+    QTimer m_sizeConstraintsTimer;
 };
 
 }
@@ -18,6 +18,7 @@
 #include "Utils_p.h"
 #include "DockRegistry_p.h"
 #include "Qt5Qt6Compat_p.h"
+#include "Config.h"
 
 #include <QMouseEvent>
 #include <QGuiApplication>
@@ -25,6 +26,10 @@
 #include <QWindow>
 #include <QDrag>
 #include <QScopedValueRollback>
+#include <QScreen>
+
+#include <algorithm>
+#include <cmath>
 
 #if defined(Q_OS_WIN)
 # include <QWindow>
@@ -94,6 +99,221 @@ FallbackMouseGrabber::~FallbackMouseGrabber() {}
 
 }
 
+void DropAreaIndex::rebuild(WindowBeingDragged *wbd, QObject *eventFilter)
+{
+    clear();
+    if (!wbd)
+        return;
+
+    m_eventFilter = eventFilter;
+
+    DockRegistry *registry = DockRegistry::self();
+    const QStringList affinities = wbd->affinities();
+
+    // nullptr with Config::Flag_DeferredDetach, the source layout can be dropped onto too
+    FloatingWindow *windowBeingDragged = wbd->floatingWindow();
+    const QWindow *draggedWindow = windowBeingDragged ? KDDockWidgets::Private::windowForWidget(windowBeingDragged)
+                                                      : nullptr;
+    const QVector<MultiSplitter*> layouts = registry->layouts();
+
+    auto addTopLevels = [&] (const QVector<QWindow*> &windows) {
+        // The lists are sorted by z-order, top-most last
+        for (int i = windows.size() - 1; i >= 0; --i) {
+            QWindow *window = windows.at(i);
+            WidgetType *tl = KDDockWidgets::Private::widgetForWindow(window);
+            if (!tl || !tl->isVisible() || tl == windowBeingDragged || window == draggedWindow
+                || KDDockWidgets::Private::isMinimized(tl))
+                continue;
+
+            TopLevel topLevel;
+            topLevel.widget = tl;
+            topLevel.window = window;
+            topLevel.geometry = window->geometry();
+            topLevel.firstDropArea = m_dropAreas.size();
+
+            if (auto fw = qobject_cast<FloatingWindow*>(tl)) {
+                // The whole floating window accepts drops, not only the drop area
+                if (registry->affinitiesMatch(fw->affinities(), affinities))
+                    m_dropAreas.push_back({ fw->dropArea(), /*coversTopLevel=*/ true });
+            } else {
+                for (MultiSplitter *layout : layouts) {
+                    auto dropArea = qobject_cast<DropArea*>(layout);
+                    if (!dropArea || !dropArea->isVisible() || KDDockWidgets::Private::windowForWidget(dropArea) != window)
+                        continue;
+
+                    if (!registry->affinitiesMatch(dropArea->affinities(), affinities))
+                        continue;
+
+                    m_dropAreas.push_back({ dropArea, /*coversTopLevel=*/ false });
+                }
+            }
+
+            topLevel.numDropAreas = m_dropAreas.size() - topLevel.firstDropArea;
+            m_topLevels.push_back(topLevel);
+
+            if (m_eventFilter)
+                window->installEventFilter(m_eventFilter);
+        }
+    };
+
+    // On Linux we don't have API to check the z-order of top-levels. So first check the floating windows
+    // and check the MainWindow last, as the MainWindow will have lower z-order as it's a parent.
+    // The floating window list is sorted by z-order, as we catch QEvent::Expose and move it to last of the list
+    addTopLevels(registry->floatingQWindows());
+    addTopLevels(registry->topLevels(/*excludeFloating=*/true));
+
+    m_isValid = true;
+}
+
+void DropAreaIndex::clear()
+{
+    if (m_eventFilter) {
+        for (const TopLevel &topLevel : qAsConst(m_topLevels)) {
+            if (topLevel.window)
+                topLevel.window->removeEventFilter(m_eventFilter);
+        }
+    }
+
+    m_topLevels.clear();
+    m_dropAreas.clear();
+    m_eventFilter = nullptr;
+    m_isValid = false;
+}
+
+WidgetType *DropAreaIndex::topLevelAt(QPoint globalPos) const
+{
+    for (const TopLevel &topLevel : m_topLevels) {
+        if (topLevel.window && topLevel.geometry.contains(globalPos)) {
+            qCDebug(toplevels) << Q_FUNC_INFO << "Found top-level" << topLevel.widget;
+            return topLevel.widget;
+        }
+    }
+
+    return nullptr;
+}
+
+DropArea *DropAreaIndex::dropAreaAt(WidgetType *topLevel, QPoint globalPos) const
+{
+    for (const TopLevel &tl : m_topLevels) {
+        if (tl.widget != topLevel || !tl.window)
+            continue;
+
+        if (tl.numDropAreas == 0)
+            return nullptr;
+
+        const DropAreaEntry &first = m_dropAreas.at(tl.firstDropArea);
+        if (first.coversTopLevel)
+            return tl.geometry.contains(globalPos) ? first.dropArea.data() : nullptr;
+
+        // Something might be on top of the drop areas, like the side bar overlay. So ask what's
+        // under the cursor and return the deepest candidate containing it.
+        const QPoint localPos = topLevel->mapFromGlobal(globalPos);
+        for (WidgetType *w = topLevel->childAt(localPos.x(), localPos.y()); w; w = KDDockWidgets::Private::parentWidget(w)) {
+            for (int i = tl.firstDropArea, end = tl.firstDropArea + tl.numDropAreas; i < end; ++i) {
+                const DropAreaEntry &entry = m_dropAreas.at(i);
+                if (entry.dropArea && entry.dropArea.data() == w)
+                    return entry.dropArea;
+            }
+        }
+
+        return nullptr;
+    }
+
+    return nullptr;
+}
+
+bool DropAreaIndex::containsTopLevel(WidgetType *topLevel) const
+{
+    for (const TopLevel &tl : m_topLevels) {
+        if (tl.widget == topLevel && tl.window)
+            return true;
+    }
+
+    return false;
+}
+
+bool DropAreaIndex::containsWindow(const QObject *window) const
+{
+    for (const TopLevel &tl : m_topLevels) {
+        if (tl.window.data() == window)
+            return true;
+    }
+
+    return false;
+}
+
+void DragStatistics::clear()
+{
+    for (QVector<qint64> &samples : m_samples)
+        samples.clear();
+}
+
+void DragStatistics::record(Phase phase, qint64 nsecs)
+{
+    m_samples[phase].push_back(nsecs);
+}
+
+int DragStatistics::count(Phase phase) const
+{
+    return m_samples[phase].size();
+}
+
+qint64 DragStatistics::total(Phase phase) const
+{
+    qint64 sum = 0;
+    for (qint64 nsecs : m_samples[phase])
+        sum += nsecs;
+
+    return sum;
+}
+
+qint64 DragStatistics::percentile(Phase phase, qreal percentile) const
+{
+    QVector<qint64> samples = m_samples[phase];
+    if (samples.isEmpty())
+        return 0;
+
+    const int rank = qBound(1, int(std::ceil(qBound(0.0, percentile, 100.0) / 100 * samples.size())), samples.size());
+    std::nth_element(samples.begin(), samples.begin() + rank - 1, samples.end());
+    return samples.at(rank - 1);
+}
+
+QString DragStatistics::summary() const
+{
+    static const char *const names[Phase_Count] = {
+        "MouseMove", "WindowMove", "HitTest", "Hover", "Indicators", "Drop"
+    };
+
+    QString result;
+    for (int i = 0; i < Phase_Count; ++i) {
+        const auto phase = Phase(i);
+        result += QStringLiteral("%1: count=%2 p50=%3us p90=%4us p99=%5us max=%6us\n")
+                      .arg(QLatin1String(names[i]))
+                      .arg(count(phase))
+                      .arg(percentile(phase, 50) / 1000.0, 0, 'f', 1)
+                      .arg(percentile(phase, 90) / 1000.0, 0, 'f', 1)
+                      .arg(percentile(phase, 99) / 1000.0, 0, 'f', 1)
+                      .arg(percentile(phase, 100) / 1000.0, 0, 'f', 1);
+    }
+
+    return result;
+}
+
+bool DragStatistics::isEmpty() const
+{
+    for (const QVector<qint64> &samples : m_samples) {
+        if (!samples.isEmpty())
+            return false;
+    }
+
+    return true;
+}
+
+ScopedDragPhaseTimer::~ScopedDragPhaseTimer()
+{
+    DragController::instance()->recordDragPhase(m_phase, m_timer.nsecsElapsed());
+}
+
 State::State(MinimalStateMachine *parent)
     : QObject(parent)
     , m_machine(parent)
@@ -158,10 +378,14 @@ StateNone::StateNone(DragController *parent)
 void StateNone::onEntry()
 {
     qCDebug(state) << "StateNone entered";
+    if (q->m_windowBeingDragged && !q->m_dragStatistics.isEmpty())
+        qCDebug(dragstatistics).noquote() << "Drag statistics:\n" << q->m_dragStatistics.summary();
+
     q->m_pressPos = QPoint();
     q->m_offset = QPoint();
     q->m_draggable = nullptr;
     q->m_windowBeingDragged.reset();
+    q->m_dropAreaIndex.clear();
     WidgetResizeHandler::s_disableAllHandlers = false; // Re-enable resize handlers
 
     q->m_nonClientDrag = false;
@@ -229,20 +453,42 @@ bool StatePreDrag::handleMouseDoubleClick()
 StateDragging::StateDragging(DragController *parent)
     : StateBase(parent)
 {
+    m_hoverTimer.setSingleShot(true);
+    m_hoverTimer.setTimerType(Qt::PreciseTimer);
+    connect(&m_hoverTimer, &QTimer::timeout, this, &StateDragging::onHoverTimeout);
 }
 
 StateDragging::~StateDragging() = default;
 
 void StateDragging::onEntry()
 {
+    q->m_dragMouseMoveCount = 0;
+    q->m_dragHoverPassCount = 0;
+    q->m_dragStatistics.clear();
+    m_hoverTimer.stop();
+    m_lastHover.invalidate();
+
     if (DockWidgetBase *dw = q->m_draggable->singleDockWidget()) {
         // When we start to drag a floating window which has a single dock widget, we save the position
         if (dw->isFloating())
             dw->saveLastFloatingGeometry();
     }
 
-    q->m_windowBeingDragged = q->m_draggable->makeWindow();
-    if (q->m_windowBeingDragged) {
+#ifdef KDDOCKWIDGETS_QTWIDGETS
+    if ((Config::self().flags() & Config::Flag_DeferredDetach) && q->m_draggable->makeWindowDetaches()) {
+        // Nothing is detached until the drop, only a snapshot follows the mouse
+        q->m_windowBeingDragged = std::unique_ptr<WindowBeingDragged>(
+            new WindowBeingDraggedProxy(q->m_draggable, q->m_pressPos - q->m_offset));
+    } else
+#endif
+    {
+        q->m_windowBeingDragged = q->m_draggable->makeWindow();
+    }
+
+    if (q->m_windowBeingDragged && q->m_windowBeingDragged->proxyWindow()) {
+        qCDebug(state) << "StateDragging entered with deferred detach. m_draggable=" << q->m_draggable;
+        q->m_dropAreaIndex.rebuild(q->m_windowBeingDragged.get(), q);
+    } else if (q->m_windowBeingDragged) {
 #if QT_VERSION >= QT_VERSION_CHECK(5, 15, 0)
 # ifdef Q_OS_WIN
         if (!q->m_nonClientDrag && KDDockWidgets::usesNativeDraggingAndResizing()) {
@@ -275,6 +521,8 @@ void StateDragging::onEntry()
                 q->m_offset.setX(fw->width() / 2);
             }
         }
+
+        q->m_dropAreaIndex.rebuild(q->m_windowBeingDragged.get(), q);
     } else {
         // Shouldn't happen
         qWarning() << Q_FUNC_INFO << "No window being dragged for " << q->m_draggable->asWidget();
@@ -284,7 +532,12 @@ void StateDragging::onEntry()
 
 bool StateDragging::handleMouseButtonRelease(QPoint globalPos)
 {
-    qCDebug(state) << "StateDragging: handleMouseButtonRelease";
+    qCDebug(state) << "StateDragging: handleMouseButtonRelease"
+                   << "; mouseMoves=" << q->m_dragMouseMoveCount
+                   << "; hoverPasses=" << q->m_dragHoverPassCount;
+
+    if (q->m_windowBeingDragged->proxyWindow())
+        return releaseDeferred(globalPos);
 
     FloatingWindow *floatingWindow = q->m_windowBeingDragged->floatingWindow();
     if (!floatingWindow) {
@@ -300,8 +553,20 @@ bool StateDragging::handleMouseButtonRelease(QPoint globalPos)
         return true;
     }
 
+    if (m_hoverTimer.isActive()) {
+        // A coalesced hover is pending, the drop must see the final position
+        m_hoverTimer.stop();
+        hover(globalPos);
+    }
+
     if (q->m_currentDropArea) {
-        if (q->m_currentDropArea->drop(q->m_windowBeingDragged.get(), globalPos)) {
+        bool accepted;
+        {
+            ScopedDragPhaseTimer timer(DragStatistics::Phase_Drop);
+            accepted = q->m_currentDropArea->drop(q->m_windowBeingDragged.get(), globalPos);
+        }
+
+        if (accepted) {
             Q_EMIT q->dropped();
         } else {
             qCDebug(state) << "StateDragging: Bailling out, drop not accepted";
@@ -314,8 +579,61 @@ bool StateDragging::handleMouseButtonRelease(QPoint globalPos)
     return true;
 }
 
+bool StateDragging::releaseDeferred(QPoint globalPos)
+{
+    if (q->m_windowBeingDragged->dockWidgets().isEmpty()) {
+        qCDebug(state) << "StateDragging: Bailling out, deleted externally";
+        Q_EMIT q->dragCanceled();
+        return true;
+    }
+
+    if (m_hoverTimer.isActive()) {
+        m_hoverTimer.stop();
+        hover(globalPos);
+    }
+
+    if (q->m_currentDropArea) {
+        // DropArea::drop() does the detaching, unless dropped back in place
+        bool accepted;
+        {
+            ScopedDragPhaseTimer timer(DragStatistics::Phase_Drop);
+            accepted = q->m_currentDropArea->drop(q->m_windowBeingDragged.get(), globalPos);
+        }
+
+        if (accepted) {
+            Q_EMIT q->dropped();
+        } else {
+            qCDebug(state) << "StateDragging: Bailling out, drop not accepted. Nothing was detached.";
+            Q_EMIT q->dragCanceled();
+        }
+    } else {
+        // Released outside of any layout, only now it really floats, where the proxy was
+        const QPoint topLeft = q->m_windowBeingDragged->proxyWindow()->position();
+        std::unique_ptr<WindowBeingDragged> detached = q->m_windowBeingDragged->draggable()->makeWindow();
+        if (FloatingWindow *fw = detached ? detached->floatingWindow() : nullptr)
+            fw->windowHandle()->setPosition(topLeft);
+
+        qCDebug(state) << "StateDragging: Not over a drop area, detached";
+        Q_EMIT q->dragCanceled();
+    }
+
+    return true;
+}
+
 bool StateDragging::handleMouseMove(QPoint globalPos)
 {
+    q->m_dragMouseMoveCount++;
+    ScopedDragPhaseTimer eventTimer(DragStatistics::Phase_MouseMove);
+
+    if (QWindow *proxy = q->m_windowBeingDragged->proxyWindow()) {
+        {
+            ScopedDragPhaseTimer timer(DragStatistics::Phase_WindowMove);
+            proxy->setPosition(globalPos - q->m_offset);
+        }
+
+        return coalesceOrHover(globalPos);
+    }
+
     FloatingWindow *fw = q->m_windowBeingDragged->floatingWindow();
     if (!fw) {
         qCDebug(state) << "Canceling drag, window was deleted";
@@ -328,8 +646,10 @@ bool StateDragging::handleMouseMove(QPoint globalPos)
         return true;
     }
 
-    if (!q->m_nonClientDrag)
+    if (!q->m_nonClientDrag) {
+        ScopedDragPhaseTimer timer(DragStatistics::Phase_WindowMove);
         fw->windowHandle()->setPosition(globalPos - q->m_offset);
+    }
 
 
     if (fw->anyNonDockable()) {
@@ -337,7 +657,39 @@ bool StateDragging::handleMouseMove(QPoint globalPos)
         return true;
     }
 
-    DropArea *dropArea = q->dropAreaUnderCursor();
+    return coalesceOrHover(globalPos);
+}
+
+bool StateDragging::coalesceOrHover(QPoint globalPos)
+{
+    if (Config::self().flags() & Config::Flag_CoalesceDragHover) {
+        m_pendingHoverPos = globalPos;
+        if (m_hoverTimer.isActive())
+            return true; // Will use the latest position once it fires
+
+        const qint64 remaining = m_lastHover.isValid() ? frameInterval() - m_lastHover.elapsed() : 0;
+        if (remaining > 0) {
+            m_hoverTimer.start(int(remaining));
+            return true;
+        }
+    }
+
+    return hover(globalPos);
+}
+
+bool StateDragging::hover(QPoint globalPos)
+{
+    q->m_dragHoverPassCount++;
+    m_lastHover.start();
+
+    DropArea *dropArea;
+    {
+        ScopedDragPhaseTimer timer(DragStatistics::Phase_HitTest);
+        if (!q->m_dropAreaIndex.isValid()) // A window was exposed, moved or resized
+            q->m_dropAreaIndex.rebuild(q->m_windowBeingDragged.get(), q);
+        dropArea = q->dropAreaUnderCursor();
+    }
+
     if (q->m_currentDropArea && dropArea != q->m_currentDropArea)
         q->m_currentDropArea->removeHover();
 
@@ -349,6 +701,7 @@ bool StateDragging::handleMouseMove(QPoint globalPos)
             }
         }
 
+        ScopedDragPhaseTimer timer(DragStatistics::Phase_Hover);
         dropArea->hover(q->m_windowBeingDragged.get(), globalPos);
     }
 
@@ -357,6 +710,32 @@ bool StateDragging::handleMouseMove(QPoint globalPos)
     return true;
 }
 
+void StateDragging::onHoverTimeout()
+{
+    if (!isActiveState())
+        return;
+
+    if (!q->m_windowBeingDragged)
+        return;
+
+    FloatingWindow *fw = q->m_windowBeingDragged->floatingWindow();
+    if ((fw && !fw->beingDeleted()) || q->m_windowBeingDragged->proxyWindow())
+        hover(m_pendingHoverPos);
+}
+
+int StateDragging::frameInterval() const
+{
+    FloatingWindow *fw = q->m_windowBeingDragged ? q->m_windowBeingDragged->floatingWindow()
+                                                 : nullptr;
+    QWindow *window = fw ? fw->windowHandle() : nullptr;
+    if (!window && q->m_windowBeingDragged)
+        window = q->m_windowBeingDragged->proxyWindow();
+    QScreen *screen = window ? window->screen() : nullptr;
+    const qreal refreshRate = screen ? screen->refreshRate() : 0;
+
+    return refreshRate > 0 ? qMax(1, qRound(1000 / refreshRate)) : 16;
+}
+
 bool StateDragging::handleMouseDoubleClick()
 {
     // See comment in StatePreDrag::handleMouseDoubleClick().
@@ -435,7 +814,13 @@ bool StateDraggingWayland::handleDrop(QDropEvent *ev, DropArea *dropArea)
     if (!mimeData || !q->m_windowBeingDragged)
         return false; // Not for us, some other user drag.
 
-    if (dropArea->drop(q->m_windowBeingDragged.get(), dropArea->mapToGlobal(Qt5Qt6Compat::eventPos(ev)))) {
+    bool accepted;
+    {
+        ScopedDragPhaseTimer timer(DragStatistics::Phase_Drop);
+        accepted = dropArea->drop(q->m_windowBeingDragged.get(), dropArea->mapToGlobal(Qt5Qt6Compat::eventPos(ev)));
+    }
+
+    if (accepted) {
         ev->setDropAction(Qt::MoveAction);
         ev->accept();
         Q_EMIT q->dropped();
@@ -554,8 +939,42 @@ WindowBeingDragged *DragController::windowBeingDragged() const
     return m_windowBeingDragged.get();
 }
 
+int DragController::dragMouseMoveCount() const
+{
+    return m_dragMouseMoveCount;
+}
+
+int DragController::dragHoverPassCount() const
+{
+    return m_dragHoverPassCount;
+}
+
+const DragStatistics &DragController::dragStatistics() const
+{
+    return m_dragStatistics;
+}
+
+void DragController::recordDragPhase(DragStatistics::Phase phase, qint64 nsecs)
+{
+    if (isDragging())
+        m_dragStatistics.record(phase, nsecs);
+}
+
 bool DragController::eventFilter(QObject *o, QEvent *e)
 {
+    if (o->isWindowType() && m_dropAreaIndex.containsWindow(o)) {
+        // The top-level rects and z-order changed. Don't return, the event is handled below too.
+        switch (e->type()) {
+        case QEvent::Expose:
+        case QEvent::Move:
+        case QEvent::Resize:
+            m_dropAreaIndex.invalidate();
+            break;
+        default:
+            break;
+        }
+    }
+
     if (m_nonClientDrag && e->type() == QEvent::Move) {
         // On Windows, non-client mouse moves are only sent at the end, so we must fake it:
         qCDebug(mouseevents) << "DragController::eventFilter e=" << e->type() << "; o=" << o;
@@ -650,27 +1069,6 @@ static QWidgetOrQuick *qtTopLevelForHWND(HWND hwnd)
     return nullptr;
 }
 #endif
-template <typename T>
-static WidgetType* qtTopLevelUnderCursor_impl(QPoint globalPos, const QVector<QWindow*> &windows, T windowBeingDragged)
-{
-    for (int i = windows.size() -1; i >= 0; --i) {
-        QWindow *window = windows.at(i);
-        auto tl = KDDockWidgets::Private::widgetForWindow(window);
-
-        if (!tl->isVisible() || tl == windowBeingDragged || KDDockWidgets::Private::isMinimized(tl))
-            continue;
-
-        if (windowBeingDragged && KDDockWidgets::Private::windowForWidget(windowBeingDragged) == KDDockWidgets::Private::windowForWidget(tl))
-            continue;
-
-        if (window->geometry().contains(globalPos)) {
-            qCDebug(toplevels) << Q_FUNC_INFO << "Found top-level" << tl;
-            return tl;
-        }
-    }
-
-    return nullptr;
-}
 
 WidgetType *DragController::qtTopLevelUnderCursor() const
 {
@@ -684,7 +1082,9 @@ WidgetType *DragController::qtTopLevelUnderCursor() const
 
         // There might be windows that don't belong to our app in between, so use win32 to travel by z-order.
         // Another solution is to set a parent on all top-levels. But this code is orthogonal.
-        HWND hwnd = HWND(m_windowBeingDragged->floatingWindow()->winId());
+        QWindow *proxy = m_windowBeingDragged->proxyWindow();
+        HWND hwnd = proxy ? HWND(proxy->winId())
+                          : HWND(m_windowBeingDragged->floatingWindow()->winId());
         while (hwnd) {
             hwnd = GetWindow(hwnd, GW_HWNDNEXT);
             RECT r;
@@ -726,13 +1126,8 @@ WidgetType *DragController::qtTopLevelUnderCursor() const
         // and check the MainWindow last, as the MainWindow will have lower z-order as it's a parent (TODO: How will it work with multiple MainWindows ?)
         // The floating window list is sorted by z-order, as we catch QEvent::Expose and move it to last of the list
 
-        FloatingWindow *tlwBeingDragged = m_windowBeingDragged->floatingWindow();
-        if (auto tl = qtTopLevelUnderCursor_impl(globalPos, DockRegistry::self()->floatingQWindows(), tlwBeingDragged))
-            return tl;
-
-        return qtTopLevelUnderCursor_impl<WidgetType*>(globalPos,
-                                                       DockRegistry::self()->topLevels(/*excludeFloating=*/true),
-                                                       tlwBeingDragged);
+        // The z-order is already taken into account by the index, see DropAreaIndex::rebuild()
+        return m_dropAreaIndex.topLevelAt(globalPos);
     }
 
     qCDebug(toplevels) << Q_FUNC_INFO << "No top-level found";
@@ -761,18 +1156,23 @@ DropArea *DragController::dropAreaUnderCursor() const
     if (!topLevel)
         return nullptr;
 
-    const QStringList affinities = m_windowBeingDragged->floatingWindow()->affinities();
+    if (topLevel->objectName() == QStringLiteral("_docks_IndicatorWindow")) {
+        qWarning() << "Indicator window should be hidden " << topLevel << topLevel->isVisible();
+        Q_ASSERT(false);
+    }
+
+    if (m_dropAreaIndex.containsTopLevel(topLevel))
+        return m_dropAreaIndex.dropAreaAt(topLevel, QCursor::pos());
+
+    // Only happens on Windows, where the top-level comes from the native z-order and might be
+    // one we don't know about, like a QWinWidget.
+    const QStringList affinities = m_windowBeingDragged->affinities();
 
     if (auto fw = qobject_cast<FloatingWindow *>(topLevel)) {
         if (DockRegistry::self()->affinitiesMatch(fw->affinities(), affinities))
             return fw->dropArea();
     }
 
-    if (topLevel->objectName() == QStringLiteral("_docks_IndicatorWindow")) {
-        qWarning() << "Indicator window should be hidden " << topLevel << topLevel->isVisible();
-        Q_ASSERT(false);
-    }
-
     if (auto dt = deepestDropAreaInTopLevel(topLevel, QCursor::pos(), affinities)) {
         return dt;
     }
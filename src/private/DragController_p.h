@@ -17,8 +17,13 @@
 #include "TitleBar_p.h"
 #include "WindowBeingDragged_p.h"
 
+#include <QElapsedTimer>
 #include <QPoint>
+#include <QPointer>
+#include <QRect>
 #include <QMimeData>
+#include <QTimer>
+#include <QVector>
 
 #include <memory>
 
@@ -45,6 +50,121 @@ private:
     MinimalStateMachine *const m_machine;
 };
 
+/**
+ * @brief Snapshot of the top-levels and drop areas a drag can hover, taken when the drag starts.
+ *
+ * Hit-testing on mouse move just walks the window rects, instead of querying DockRegistry. In the
+ * window under the cursor, the widget at the cursor is then matched against the drop areas that
+ * were collected for it, with affinities already checked. It's invalidated when any of the
+ * participating windows is exposed, moved or resized, and rebuilt on the next mouse move.
+ */
+class DOCKS_EXPORT_FOR_UNIT_TESTS DropAreaIndex
+{
+public:
+    ///@brief Takes a snapshot of the top-levels which can be dropped onto, excluding @p windowBeingDragged
+    ///@param eventFilter if not nullptr, it's installed on the participating windows, so it can call invalidate()
+    void rebuild(WindowBeingDragged *windowBeingDragged, QObject *eventFilter);
+    void clear();
+
+    bool isValid() const { return m_isValid; }
+    void invalidate() { m_isValid = false; }
+
+    ///@brief returns the top-most top-level under @p globalPos
+    WidgetType *topLevelAt(QPoint globalPos) const;
+
+    ///@brief returns the deepest DropArea in @p topLevel containing the widget under @p globalPos,
+    ///with matching affinities. Returns nullptr if something else is on top, like the side bar overlay
+    DropArea *dropAreaAt(WidgetType *topLevel, QPoint globalPos) const;
+
+    ///@brief returns whether @p topLevel is part of the snapshot
+    bool containsTopLevel(WidgetType *topLevel) const;
+
+    ///@brief returns whether @p window is the QWindow of one of the top-levels in the snapshot
+    bool containsWindow(const QObject *window) const;
+
+private:
+    struct TopLevel {
+        WidgetType *widget;
+        QPointer<QWindow> window;
+        QRect geometry;
+        int firstDropArea;
+        int numDropAreas;
+    };
+
+    struct DropAreaEntry {
+        QPointer<DropArea> dropArea;
+        bool coversTopLevel; // true for floating windows, the whole window accepts drops
+    };
+
+    QVector<TopLevel> m_topLevels; // Sorted by z-order, top-most first
+    QVector<DropAreaEntry> m_dropAreas; // Grouped by top-level
+    QObject *m_eventFilter = nullptr;
+    bool m_isValid = false;
+};
+
+/**
+ * @brief Timings of the work done for each mouse event of a drag, split by phase.
+ *
+ * Collected by DragController, see DragController::dragStatistics(). A summary is also printed
+ * when each drag ends, if the "kdab.docks.dragstatistics" logging category is enabled.
+ */
+class DOCKS_EXPORT DragStatistics
+{
+public:
+    enum Phase {
+        Phase_MouseMove = 0, ///< All of the processing of a mouse move
+        Phase_WindowMove, ///< Moving the dragged window, or its proxy
+        Phase_HitTest, ///< Finding the drop area under the cursor
+        Phase_Hover, ///< DropArea::hover(), including Phase_Indicators
+        Phase_Indicators, ///< Updating the drop indicators of the hovered drop area
+        Phase_Drop, ///< DropArea::drop(), at most once per drag
+        Phase_Count
+    };
+
+    ///@brief removes all samples
+    void clear();
+
+    ///@brief adds a sample of @p nsecs nanoseconds to @p phase
+    void record(Phase phase, qint64 nsecs);
+
+    ///@brief returns the number of samples recorded for @p phase
+    int count(Phase phase) const;
+
+    ///@brief returns the sum of all samples of @p phase, in nanoseconds
+    qint64 total(Phase phase) const;
+
+    ///@brief returns the @p percentile (0 to 100) of the samples of @p phase, in nanoseconds
+    ///Uses the nearest-rank method. Returns 0 if there's no samples.
+    qint64 percentile(Phase phase, qreal percentile) const;
+
+    ///@brief returns a one line per phase summary with the count, p50, p90, p99 and max, in microseconds
+    QString summary() const;
+
+    ///@brief returns whether no samples were recorded
+    bool isEmpty() const;
+
+private:
+    QVector<qint64> m_samples[Phase_Count];
+};
+
+///@brief Adds the time spent in its scope to the statistics of the current drag
+class ScopedDragPhaseTimer
+{
+public:
+    explicit ScopedDragPhaseTimer(DragStatistics::Phase phase)
+        : m_phase(phase)
+    {
+        m_timer.start();
+    }
+
+    ~ScopedDragPhaseTimer();
+
+private:
+    Q_DISABLE_COPY(ScopedDragPhaseTimer)
+    const DragStatistics::Phase m_phase;
+    QElapsedTimer m_timer;
+};
+
 class MinimalStateMachine : public QObject
 {
     Q_OBJECT
@@ -90,6 +210,20 @@ public:
     /// Experimental, internal, not for general use.
     void enableFallbackMouseGrabber();
 
+    ///@brief returns how many mouse moves the current, or last, drag received
+    int dragMouseMoveCount() const;
+
+    ///@brief returns how many times the current, or last, drag resolved the drop area under the
+    ///cursor and updated the drop indicators.
+    ///Lower than @ref dragMouseMoveCount() if Config::Flag_CoalesceDragHover is set.
+    int dragHoverPassCount() const;
+
+    ///@brief returns the timings of the current, or last, drag
+    const DragStatistics &dragStatistics() const;
+
+    ///@brief adds a sample to the statistics of the current drag. Does nothing if not dragging.
+    void recordDragPhase(DragStatistics::Phase phase, qint64 nsecs);
+
 Q_SIGNALS:
     void mousePressed();
     void manhattanLengthMove();
@@ -118,7 +252,11 @@ private:
     Draggable::List m_draggables;
     Draggable *m_draggable = nullptr;
     std::unique_ptr<WindowBeingDragged> m_windowBeingDragged;
+    DropAreaIndex m_dropAreaIndex;
     DropArea *m_currentDropArea = nullptr;
+    int m_dragMouseMoveCount = 0;
+    int m_dragHoverPassCount = 0;
+    DragStatistics m_dragStatistics;
     bool m_nonClientDrag = false;
     FallbackMouseGrabber *m_fallbackMouseGrabber = nullptr;
 };
@@ -181,6 +319,20 @@ public:
     bool handleMouseButtonRelease(QPoint globalPos) override;
     bool handleMouseMove(QPoint globalPos) override;
     bool handleMouseDoubleClick() override;
+
+private:
+    ///@brief Resolves the drop area under @p globalPos and hovers it
+    bool hover(QPoint globalPos);
+    ///@brief Hovers now, or later if Config::Flag_CoalesceDragHover is set
+    bool coalesceOrHover(QPoint globalPos);
+    ///@brief Release handling for Config::Flag_DeferredDetach, where nothing was detached yet
+    bool releaseDeferred(QPoint globalPos);
+    void onHoverTimeout();
+    int frameInterval() const;
+
+    QTimer m_hoverTimer; // For Config::Flag_CoalesceDragHover
+    QElapsedTimer m_lastHover;
+    QPoint m_pendingHoverPos;
 };
 
 // Used on wayland only to use QDrag instead of setting geometry on mouse-move.
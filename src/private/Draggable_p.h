@@ -76,6 +76,14 @@ public:
      */
     virtual DockWidgetBase* singleDockWidget() const = 0;
 
+    /**
+     * @brief Returns whether makeWindow() would detach this draggable from its layout, as opposed
+     * to just dragging the window it's already in.
+     *
+     * Used by Config::Flag_DeferredDetach, which postpones the detaching until the drop.
+     */
+    virtual bool makeWindowDetaches() const { return false; }
+
 private:
     class Private;
     Private *const d;
@@ -24,9 +24,12 @@
 
 // #include "indicators/AnimatedIndicators_p.h"
 #include "WindowBeingDragged_p.h"
+#include "DragController_p.h"
 
 using namespace KDDockWidgets;
 
+static const int s_frameRectsGridSize = 8;
+
 /**
  * @file
  * @brief A MultiSplitter with support for drop indicators when hovering over.
@@ -63,19 +66,93 @@ Frame::List DropArea::frames() const
     return findChildren<Frame *>(QString(), Qt::FindDirectChildrenOnly);
 }
 
-Frame *DropArea::frameContainingPos(QPoint globalPos) const
+Frame *DropArea::frameContainingPos(QPoint globalPos)
+{
+    if (!m_frameRectsValid || m_frameRectsRoot != rootItem())
+        rebuildFrameRects();
+
+    // A single mapping, instead of one per frame
+    const QPoint origin = QWidgetAdapter::mapToGlobal(QPoint(0, 0));
+    if (origin != m_frameRectsOrigin) {
+        const QPoint delta = origin - m_frameRectsOrigin;
+        for (FrameRect &frameRect : m_frameRects)
+            frameRect.geometry.translate(delta);
+        m_frameRectsBounds.translate(delta);
+        m_frameRectsOrigin = origin;
+    }
+
+    if (!m_frameRectsBounds.contains(globalPos))
+        return nullptr;
+
+    const int cellWidth = qMax(1, (m_frameRectsBounds.width() + s_frameRectsGridSize - 1) / s_frameRectsGridSize);
+    const int cellHeight = qMax(1, (m_frameRectsBounds.height() + s_frameRectsGridSize - 1) / s_frameRectsGridSize);
+    const int column = qMin(s_frameRectsGridSize - 1, (globalPos.x() - m_frameRectsBounds.x()) / cellWidth);
+    const int row = qMin(s_frameRectsGridSize - 1, (globalPos.y() - m_frameRectsBounds.y()) / cellHeight);
+
+    for (int index : m_frameRectCells.at(row * s_frameRectsGridSize + column)) {
+        const FrameRect &frameRect = m_frameRects.at(index);
+        if (frameRect.frame && frameRect.frame->QWidgetAdapter::isVisible() && frameRect.geometry.contains(globalPos))
+            return frameRect.frame;
+    }
+
+    return nullptr;
+}
+
+void DropArea::rebuildFrameRects()
 {
+    m_frameRects.clear();
+    m_frameRectCells.fill({}, s_frameRectsGridSize * s_frameRectsGridSize);
+    m_frameRectsOrigin = QWidgetAdapter::mapToGlobal(QPoint(0, 0));
+    m_frameRectsBounds = QRect(m_frameRectsOrigin, QWidgetAdapter::size());
+    m_frameRectsRoot = rootItem();
+    m_frameRectsValid = true;
+
+    connect(m_frameRectsRoot, &Layouting::ItemContainer::numItemsChanged,
+            this, &DropArea::invalidateFrameRects, Qt::UniqueConnection);
+    connect(m_frameRectsRoot, &Layouting::ItemContainer::numVisibleItemsChanged,
+            this, &DropArea::invalidateFrameRects, Qt::UniqueConnection);
+
+    const int cellWidth = qMax(1, (m_frameRectsBounds.width() + s_frameRectsGridSize - 1) / s_frameRectsGridSize);
+    const int cellHeight = qMax(1, (m_frameRectsBounds.height() + s_frameRectsGridSize - 1) / s_frameRectsGridSize);
+
     const Layouting::Item::List &items = this->items();
     for (Layouting::Item *item : items) {
+        connect(item, &Layouting::Item::geometryChanged,
+                this, &DropArea::invalidateFrameRects, Qt::UniqueConnection);
+
+        // Item geometries are relative to the parent container, which can move without resizing
+        for (Layouting::ItemContainer *c = item->parentContainer(); c && c != m_frameRectsRoot; c = c->parentContainer()) {
+            connect(c, &Layouting::Item::geometryChanged,
+                    this, &DropArea::invalidateFrameRects, Qt::UniqueConnection);
+        }
+
         auto frame = static_cast<Frame*>(item->guestAsQObject());
-        if (!frame || !frame->QWidgetAdapter::isVisible()) {
+        if (!frame)
             continue;
-        }
 
-        if (frame->containsMouse(globalPos))
-            return frame;
+        // Frames are children of the DropArea
+        const QRect geometry = frame->QWidgetAdapter::geometry().translated(m_frameRectsOrigin);
+        const QRect r = geometry.intersected(m_frameRectsBounds);
+        if (r.isEmpty())
+            continue;
+
+        const int index = m_frameRects.size();
+        m_frameRects.push_back({ frame, geometry });
+
+        const int firstColumn = (r.left() - m_frameRectsBounds.x()) / cellWidth;
+        const int lastColumn = qMin(s_frameRectsGridSize - 1, (r.right() - m_frameRectsBounds.x()) / cellWidth);
+        const int firstRow = (r.top() - m_frameRectsBounds.y()) / cellHeight;
+        const int lastRow = qMin(s_frameRectsGridSize - 1, (r.bottom() - m_frameRectsBounds.y()) / cellHeight);
+        for (int row = firstRow; row <= lastRow; ++row) {
+            for (int column = firstColumn; column <= lastColumn; ++column)
+                m_frameRectCells[row * s_frameRectsGridSize + column].push_back(index);
+        }
     }
-    return nullptr;
+}
+
+void DropArea::invalidateFrameRects()
+{
+    m_frameRectsValid = false;
 }
 
 void DropArea::updateFloatingActions()
@@ -192,24 +269,13 @@ DropIndicatorOverlayInterface::DropLocation DropArea::hover(WindowBeingDragged *
     }
 
     Frame *frame = frameContainingPos(globalPos); // Frame is nullptr if MainWindowOption_HasCentralFrame isn't set
+
+    ScopedDragPhaseTimer timer(DragStatistics::Phase_Indicators);
     m_dropIndicatorOverlay->setWindowBeingDragged(true);
     m_dropIndicatorOverlay->setHoveredFrame(frame);
     return m_dropIndicatorOverlay->hover(globalPos);
 }
 
-static bool isOutterLocation(DropIndicatorOverlayInterface::DropLocation location)
-{
-    switch (location) {
-    case DropIndicatorOverlayInterface::DropLocation_OutterLeft:
-    case DropIndicatorOverlayInterface::DropLocation_OutterTop:
-    case DropIndicatorOverlayInterface::DropLocation_OutterRight:
-    case DropIndicatorOverlayInterface::DropLocation_OutterBottom:
-        return true;
-    default:
-        return false;
-    }
-}
-
 bool DropArea::drop(WindowBeingDragged *droppedWindow, QPoint globalPos)
 {
     FloatingWindow *floatingWindow = droppedWindow->floatingWindow();
@@ -229,7 +295,7 @@ bool DropArea::drop(WindowBeingDragged *droppedWindow, QPoint globalPos)
     hover(droppedWindow, globalPos);
     auto droploc = m_dropIndicatorOverlay->currentDropLocation();
     Frame *acceptingFrame = m_dropIndicatorOverlay->hoveredFrame();
-    if (!(acceptingFrame || isOutterLocation(droploc))) {
+    if (!(acceptingFrame || DropIndicatorOverlayInterface::isOutterLocation(droploc))) {
         qWarning() << "DropArea::drop: asserted with frame=" << acceptingFrame
                    << "; Location=" << droploc;
         return false;
@@ -244,16 +310,21 @@ bool DropArea::drop(WindowBeingDragged *draggedWindow, Frame *acceptingFrame,
     FloatingWindow *droppedWindow = draggedWindow ? draggedWindow->floatingWindow()
                                                   : nullptr;
 
-    if (isWayland() && !droppedWindow) {
-        // This is the Wayland special case.
+    if (!droppedWindow && (isWayland() || draggedWindow->proxyWindow())) {
+        // This is the Wayland special case, also used by Config::Flag_DeferredDetach.
         // With other platforms, when detaching a tab or dock widget we create the FloatingWindow immediately.
         // With Wayland we delay the floating window until we drop it.
         // Ofc, we could just dock the dockwidget without the temporary FloatingWindow, but this way we reuse
         // 99% of the rest of the code, without adding more wayland special cases
+        if (draggedWindow->isInPlaceDrop(acceptingFrame, droploc)) {
+            qCDebug(dropping) << "DropArea::drop: Dropped back in place, nothing to do";
+            return false;
+        }
+
         droppedWindow = draggedWindow->draggable()->makeWindow()->floatingWindow();
         if (!droppedWindow) {
             // Doesn't happen
-            qWarning() << Q_FUNC_INFO << "Wayland: Expected window" << draggedWindow;
+            qWarning() << Q_FUNC_INFO << "Expected window" << draggedWindow;
             return false;
         }
     }
@@ -25,6 +25,8 @@
 #include "MultiSplitter_p.h"
 #include "DropIndicatorOverlayInterface_p.h"
 
+#include <QPointer>
+
 class TestDocks;
 
 namespace KDDockWidgets {
@@ -74,12 +76,30 @@ private:
     bool validateAffinity(T *, Frame *acceptingFrame = nullptr) const;
     bool drop(WindowBeingDragged *draggedWindow, Frame *acceptingFrame, DropIndicatorOverlayInterface::DropLocation);
     bool drop(QWidgetOrQuick *droppedwindow, KDDockWidgets::Location location, Frame *relativeTo);
-    Frame *frameContainingPos(QPoint globalPos) const;
+    Frame *frameContainingPos(QPoint globalPos);
     void updateFloatingActions();
 
+    ///@brief the cache used by frameContainingPos(), see m_frameRects
+    void rebuildFrameRects();
+    void invalidateFrameRects();
+
     bool m_inDestructor = false;
     QString m_affinityName;
     DropIndicatorOverlayInterface *m_dropIndicatorOverlay = nullptr;
+
+    // The global geometry of each frame, bucketed into a grid. So hovering is a lookup instead of
+    // mapping each frame from global. Rebuilt on the next hover after the layout changes, and
+    // translated if the DropArea moved.
+    struct FrameRect {
+        QPointer<Frame> frame;
+        QRect geometry;
+    };
+    QVector<FrameRect> m_frameRects;
+    QVector<QVector<int>> m_frameRectCells; // Indexes into m_frameRects
+    QRect m_frameRectsBounds;
+    QPoint m_frameRectsOrigin;
+    QPointer<Layouting::ItemContainer> m_frameRectsRoot;
+    bool m_frameRectsValid = false;
 };
 }
 
@@ -101,6 +101,19 @@ KDDockWidgets::Location DropIndicatorOverlayInterface::multisplitterLocationFor(
     return KDDockWidgets::Location_None;
 }
 
+bool DropIndicatorOverlayInterface::isOutterLocation(DropIndicatorOverlayInterface::DropLocation location)
+{
+    switch (location) {
+    case DropIndicatorOverlayInterface::DropLocation_OutterLeft:
+    case DropIndicatorOverlayInterface::DropLocation_OutterTop:
+    case DropIndicatorOverlayInterface::DropLocation_OutterRight:
+    case DropIndicatorOverlayInterface::DropLocation_OutterBottom:
+        return true;
+    default:
+        return false;
+    }
+}
+
 void DropIndicatorOverlayInterface::onFrameDestroyed()
 {
     setHoveredFrame(nullptr);
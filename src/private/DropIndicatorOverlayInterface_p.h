@@ -61,6 +61,9 @@ public:
 
     static KDDockWidgets::Location multisplitterLocationFor(DropLocation);
 
+    ///@brief returns whether @p location is one of the indicators at the drop area's outer edges
+    static bool isOutterLocation(DropLocation location);
+
 Q_SIGNALS:
     void hoveredFrameChanged(KDDockWidgets::Frame *);
     void hoveredFrameRectChanged();
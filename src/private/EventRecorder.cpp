@@ -0,0 +1,282 @@
+/*
+  This file is part of KDDockWidgets.
+
+  SPDX-FileCopyrightText: 2019-2020 Klarälvdalens Datakonsult AB, a KDAB Group company <info@kdab.com>
+  Author: Sérgio Martins <sergio.martins@kdab.com>
+
+  SPDX-License-Identifier: GPL-2.0-only OR GPL-3.0-only
+
+  Contact KDAB at <info@kdab.com> for commercial licensing options.
+*/
+
+/**
+ * @file
+ * @brief Records mouse events of a running application and replays them. Used for debugging and benchmarking only.
+ *
+ * @author Sérgio Martins \<sergio.martins@kdab.com\>
+ */
+
+#include "EventRecorder_p.h"
+#include "DockRegistry_p.h"
+#include "../LayoutSaver_p.h"
+#include "Logging_p.h"
+#include "Utils_p.h"
+#include "Qt5Qt6Compat_p.h"
+#include "DockWidget.h"
+#include "MainWindow.h"
+
+#include <QApplication>
+#include <QCryptographicHash>
+#include <QCursor>
+#include <QDebug>
+#include <QEventLoop>
+#include <QFile>
+#include <QJsonDocument>
+#include <QMouseEvent>
+#include <QPointer>
+#include <QTimer>
+#include <QWidget>
+
+using namespace KDDockWidgets;
+using namespace KDDockWidgets::Debug;
+
+namespace {
+
+struct EventTypeName
+{
+    QEvent::Type type;
+    const char *name;
+};
+
+const EventTypeName s_eventTypeNames[] = {
+    { QEvent::MouseButtonPress, "press" },
+    { QEvent::MouseButtonRelease, "release" },
+    { QEvent::MouseButtonDblClick, "doubleclick" },
+    { QEvent::MouseMove, "move" },
+    { QEvent::NonClientAreaMouseButtonPress, "ncpress" },
+    { QEvent::NonClientAreaMouseButtonRelease, "ncrelease" },
+    { QEvent::NonClientAreaMouseMove, "ncmove" }
+};
+
+QString nameForEventType(QEvent::Type type)
+{
+    for (const EventTypeName &entry : s_eventTypeNames) {
+        if (entry.type == type)
+            return QLatin1String(entry.name);
+    }
+
+    return {};
+}
+
+QEvent::Type eventTypeForName(const QString &name)
+{
+    for (const EventTypeName &entry : s_eventTypeNames) {
+        if (name == QLatin1String(entry.name))
+            return entry.type;
+    }
+
+    return QEvent::None;
+}
+
+void waitMs(int msecs)
+{
+    QEventLoop loop;
+    QTimer::singleShot(msecs, &loop, &QEventLoop::quit);
+    loop.exec();
+}
+
+}
+
+EventRecorder::EventRecorder(const QString &fileName, QObject *parent)
+    : QObject(parent)
+    , m_fileName(fileName)
+{
+    qApp->installEventFilter(this);
+    connect(qApp, &QCoreApplication::aboutToQuit, this, &EventRecorder::save);
+}
+
+EventRecorder::~EventRecorder()
+{
+    qApp->removeEventFilter(this);
+    save();
+}
+
+int EventRecorder::numEvents() const
+{
+    return m_events.size();
+}
+
+QByteArray EventRecorder::toJson() const
+{
+    QJsonObject root;
+    root.insert(QStringLiteral("layout"), m_layout);
+    root.insert(QStringLiteral("events"), m_events);
+    return QJsonDocument(root).toJson();
+}
+
+bool EventRecorder::save() const
+{
+    if (m_fileName.isEmpty() || m_events.isEmpty())
+        return false;
+
+    QFile f(m_fileName);
+    if (!f.open(QIODevice::WriteOnly)) {
+        qWarning() << Q_FUNC_INFO << "Failed to open" << m_fileName << f.errorString();
+        return false;
+    }
+
+    f.write(toJson());
+    return true;
+}
+
+bool EventRecorder::eventFilter(QObject *o, QEvent *e)
+{
+    // Only record what the windows receive, the same event is then sent to a widget and its parents
+    if (!o->isWindowType())
+        return false;
+
+    QMouseEvent *me = mouseEvent(e);
+    if (!me)
+        return false;
+
+    // The press which Qt turns into a double-click isn't delivered to widgets
+    if (me->flags() & Qt::MouseEventCreatedDoubleClick)
+        return false;
+
+    if (!m_elapsed.isValid()) {
+        if (e->type() != QEvent::MouseButtonPress && e->type() != QEvent::NonClientAreaMouseButtonPress)
+            return false;
+
+        m_elapsed.start();
+        const QByteArray layout = LayoutSaver().serializeLayout();
+        m_layout = QJsonDocument::fromJson(layout).object();
+    }
+
+    const QPoint globalPos = Qt5Qt6Compat::eventGlobalPos(me);
+    QJsonObject event;
+    event.insert(QStringLiteral("t"), m_elapsed.nsecsElapsed() / 1000000.0);
+    event.insert(QStringLiteral("type"), nameForEventType(e->type()));
+    event.insert(QStringLiteral("x"), globalPos.x());
+    event.insert(QStringLiteral("y"), globalPos.y());
+    event.insert(QStringLiteral("button"), int(me->button()));
+    event.insert(QStringLiteral("buttons"), int(me->buttons()));
+    event.insert(QStringLiteral("modifiers"), int(me->modifiers()));
+    m_events.push_back(event);
+
+    return false;
+}
+
+bool EventReplayer::load(const QByteArray &recording)
+{
+    QJsonParseError error;
+    const QJsonDocument doc = QJsonDocument::fromJson(recording, &error);
+    if (error.error != QJsonParseError::NoError) {
+        qWarning() << Q_FUNC_INFO << "Invalid recording" << error.errorString();
+        return false;
+    }
+
+    m_layout = doc.object().value(QStringLiteral("layout")).toObject();
+    m_events = doc.object().value(QStringLiteral("events")).toArray();
+    return true;
+}
+
+int EventReplayer::numEvents() const
+{
+    return m_events.size();
+}
+
+bool EventReplayer::restoreLayout()
+{
+    const QByteArray layoutJson = QJsonDocument(m_layout).toJson();
+
+    {
+        LayoutSaver::Layout layout;
+        if (!layout.fromJson(layoutJson)) {
+            qWarning() << Q_FUNC_INFO << "Recording has no valid layout";
+            return false;
+        }
+
+        DockRegistry *registry = DockRegistry::self();
+        for (const LayoutSaver::MainWindow &mw : qAsConst(layout.mainWindows)) {
+            if (!registry->mainWindowByName(mw.uniqueName)) {
+                auto mainWindow = new MainWindow(mw.uniqueName, mw.options);
+                mainWindow->show();
+            }
+        }
+
+        const QStringList dockWidgetNames = layout.dockWidgetNames();
+        for (const QString &name : dockWidgetNames) {
+            if (!registry->dockByName(name)) {
+                auto dw = new DockWidget(name);
+                dw->setWidget(new QWidget());
+            }
+        }
+    }
+
+    return LayoutSaver().restoreLayout(layoutJson);
+}
+
+QVector<EventReplayer::EventTiming> EventReplayer::replay(bool honorTiming)
+{
+    QVector<EventTiming> timings;
+    timings.reserve(m_events.size());
+
+    QPointer<QWidget> implicitGrabber; // The widget that got the press, while a button is held
+    double previousTime = 0;
+
+    for (const QJsonValue &value : qAsConst(m_events)) {
+        const QJsonObject event = value.toObject();
+        const QEvent::Type type = eventTypeForName(event.value(QStringLiteral("type")).toString());
+        if (type == QEvent::None)
+            continue;
+
+        const double time = event.value(QStringLiteral("t")).toDouble();
+        if (honorTiming && time > previousTime)
+            waitMs(int(time - previousTime));
+        previousTime = time;
+
+        const QPoint globalPos(event.value(QStringLiteral("x")).toInt(), event.value(QStringLiteral("y")).toInt());
+        const auto button = Qt::MouseButton(event.value(QStringLiteral("button")).toInt());
+        const auto buttons = Qt::MouseButtons(event.value(QStringLiteral("buttons")).toInt());
+        const auto modifiers = Qt::KeyboardModifiers(event.value(QStringLiteral("modifiers")).toInt());
+
+        const QEvent typeOnly(type);
+        QWidget *receiver = QWidget::mouseGrabber();
+        if (!receiver && isNonClientMouseEvent(&typeOnly))
+            receiver = QApplication::topLevelAt(globalPos);
+        if (!receiver)
+            receiver = implicitGrabber;
+        if (!receiver)
+            receiver = QApplication::widgetAt(globalPos);
+
+        if (!receiver) {
+            qCDebug(mouseevents) << Q_FUNC_INFO << "Nothing under" << globalPos;
+            continue;
+        }
+
+        if (type == QEvent::MouseButtonPress || type == QEvent::MouseButtonDblClick)
+            implicitGrabber = receiver;
+
+        QCursor::setPos(globalPos);
+        QMouseEvent ev(type, receiver->mapFromGlobal(globalPos), receiver->window()->mapFromGlobal(globalPos),
+                       globalPos, button, buttons, modifiers);
+
+        QElapsedTimer timer;
+        timer.start();
+        qApp->sendEvent(receiver, &ev);
+        QCoreApplication::sendPostedEvents();
+        timings.push_back({ type, globalPos, timer.nsecsElapsed() });
+
+        if (!buttons)
+            implicitGrabber = nullptr;
+    }
+
+    return timings;
+}
+
+QByteArray EventReplayer::layoutChecksum()
+{
+    const QByteArray layout = LayoutSaver().serializeLayout();
+    const QByteArray compact = QJsonDocument::fromJson(layout).toJson(QJsonDocument::Compact);
+    return QCryptographicHash::hash(compact, QCryptographicHash::Sha1).toHex();
+}
@@ -0,0 +1,116 @@
+/*
+  This file is part of KDDockWidgets.
+
+  SPDX-FileCopyrightText: 2019-2020 Klarälvdalens Datakonsult AB, a KDAB Group company <info@kdab.com>
+  Author: Sérgio Martins <sergio.martins@kdab.com>
+
+  SPDX-License-Identifier: GPL-2.0-only OR GPL-3.0-only
+
+  Contact KDAB at <info@kdab.com> for commercial licensing options.
+*/
+
+/**
+ * @file
+ * @brief Records mouse events of a running application and replays them. Used for debugging and benchmarking only.
+ *
+ * @author Sérgio Martins \<sergio.martins@kdab.com\>
+ */
+
+#ifndef KD_EVENTRECORDER_P_H
+#define KD_EVENTRECORDER_P_H
+
+#include "docks_export.h"
+
+#include <QElapsedTimer>
+#include <QEvent>
+#include <QJsonArray>
+#include <QJsonObject>
+#include <QObject>
+#include <QPoint>
+#include <QVector>
+
+namespace KDDockWidgets {
+namespace Debug {
+
+/**
+ * @brief Records the mouse events of the application into a file, so they can be replayed with EventReplayer.
+ * Created once per session by DockRegistry, if the KDDOCKWIDGETS_RECORD_EVENTS environment variable is set to a file name.
+ * Created by DockRegistry if the KDDOCKWIDGETS_RECORD_EVENTS environment variable is set to a file name.
+ * The recording starts with the first mouse press, which is also when the layout is saved,
+ * and is written to the file when the application quits.
+ *
+ * The file is json: the layout, as returned by LayoutSaver::serializeLayout(), and the events,
+ * each with its time in ms, type, global position, buttons and modifiers.
+ */
+class DOCKS_EXPORT EventRecorder : public QObject
+{
+    Q_OBJECT
+public:
+    explicit EventRecorder(const QString &fileName, QObject *parent = nullptr);
+    ~EventRecorder() override;
+
+    ///@brief returns the number of events recorded so far
+    int numEvents() const;
+
+    ///@brief returns the recording, in the same format as written to the file
+    QByteArray toJson() const;
+
+    ///@brief writes the recording to the file passed in the constructor
+    bool save() const;
+
+protected:
+    bool eventFilter(QObject *, QEvent *) override;
+
+private:
+    const QString m_fileName;
+    QElapsedTimer m_elapsed; // Started with the first press
+    QJsonObject m_layout;
+    QJsonArray m_events;
+};
+
+/**
+ * @brief Replays a recording made by EventRecorder, measuring how long each event takes to process.
+ *
+ * Like Qt does, each event is sent to the mouse grabber, or to the widget which got the press while
+ * a button is held, or otherwise to the widget under the cursor.
+ */
+class DOCKS_EXPORT EventReplayer
+{
+public:
+    struct EventTiming
+    {
+        QEvent::Type type;
+        QPoint globalPos;
+        qint64 nsecs; ///< Includes processing the events posted while handling it
+    };
+
+    ///@brief loads a recording. Returns false if it's not valid
+    bool load(const QByteArray &recording);
+
+    ///@brief returns the number of events in the loaded recording
+    int numEvents() const;
+
+    /**
+     * @brief Restores the layout the recording started with.
+     *
+     * Main windows and dock widgets which don't exist yet are created, the latter with an empty guest
+     * widget, so a recording can be replayed outside of the application that made it.
+     */
+    bool restoreLayout();
+
+    ///@brief sends the recorded events, one at a time
+    ///@param honorTiming if true, waits between events as long as the user did
+    QVector<EventTiming> replay(bool honorTiming = false);
+
+    ///@brief returns a SHA-1 of the current layout, to compare the results of replays
+    static QByteArray layoutChecksum();
+
+private:
+    QJsonObject m_layout;
+    QJsonArray m_events;
+};
+
+}
+}
+
+#endif
@@ -21,6 +21,10 @@
 #include "Config.h"
 #include "FrameworkWidgetFactory.h"
 
+#ifdef KDDOCKWIDGETS_QTWIDGETS
+# include "FloatingWindowPool_p.h"
+#endif
+
 #include <QCloseEvent>
 #include <QAbstractNativeEventFilter>
 #include <QWindow>
@@ -164,6 +168,21 @@ FloatingWindow::FloatingWindow(MainWindowBase *parent)
 
 FloatingWindow::FloatingWindow(Frame *frame, MainWindowBase *parent)
     : FloatingWindow(hackFindParentHarder(frame, parent))
+{
+    addFirstFrame(frame);
+}
+
+FloatingWindow::~FloatingWindow()
+{
+    m_inDtor = true;
+    disconnect(m_layoutDestroyedConnection);
+    delete m_nchittestFilter;
+
+    DockRegistry::self()->unregisterFloatingWindow(this);
+    qCDebug(creation) << "~FloatingWindow";
+}
+
+void FloatingWindow::addFirstFrame(Frame *frame)
 {
     m_disableSetVisible = true;
     // Adding a widget will trigger onFrameCountChanged, which triggers a setVisible(true).
@@ -173,16 +192,48 @@ FloatingWindow::FloatingWindow(Frame *frame, MainWindowBase *parent)
     m_disableSetVisible = false;
 }
 
-FloatingWindow::~FloatingWindow()
+#ifdef KDDOCKWIDGETS_QTWIDGETS
+bool FloatingWindow::isRecyclable() const
 {
-    m_inDtor = true;
-    disconnect(m_layoutDestroyedConnection);
-    delete m_nchittestFilter;
+    return m_dropArea && !m_inDtor && !m_pooled && m_dropArea->visibleCount() == 0;
+}
 
+void FloatingWindow::enterPool()
+{
+    m_pooled = true;
+    m_deleteScheduled = false;
     DockRegistry::self()->unregisterFloatingWindow(this);
-    qCDebug(creation) << "~FloatingWindow";
+
+    hide();
+    setWindowState(Qt::WindowNoState);
+
+    // Deleting the window would have deleted the placeholders too
+    if (m_dropArea->count() > 0)
+        m_dropArea->clearLayout();
+
+    updateTitleBarVisibility();
+#ifdef Q_OS_WIN
+    m_lastHitTest = 0;
+#endif
+
+    // The expensive part, which is why we're pooling. No-op if already created.
+    create();
 }
 
+void FloatingWindow::leavePool(Frame *frame, MainWindowBase *candidateParent)
+{
+    MainWindowBase *parent = actualParent(hackFindParentHarder(frame, candidateParent));
+    if (parentWidget() != parent)
+        setParent(parent, windowFlags());
+
+    m_pooled = false;
+    DockRegistry::self()->registerFloatingWindow(this);
+    qCDebug(creation) << "FloatingWindow reused" << this;
+
+    addFirstFrame(frame);
+}
+#endif
+
 void FloatingWindow::setupWindow()
 {
     // Does some minor setup on our QWindow.
@@ -285,8 +336,17 @@ void FloatingWindow::setSuggestedGeometry(QRect suggestedRect, bool preserveCent
 
 void FloatingWindow::scheduleDeleteLater()
 {
+    if (m_pooled)
+        return;
+
     m_deleteScheduled = true;
     DockRegistry::self()->unregisterFloatingWindow(this);
+
+#ifdef KDDOCKWIDGETS_QTWIDGETS
+    if (!m_inDtor && Config::self().floatingWindowPoolSize() > 0 && FloatingWindowPool::self()->recycleLater(this))
+        return;
+#endif
+
     deleteLater();
 }
 
@@ -343,7 +403,7 @@ bool FloatingWindow::hasSingleDockWidget() const
 
 bool FloatingWindow::beingDeleted() const
 {
-    if (m_deleteScheduled || m_inDtor)
+    if (m_deleteScheduled || m_pooled || m_inDtor)
         return true;
 
     // TODO: Confusing logic
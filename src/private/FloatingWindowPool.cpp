@@ -0,0 +1,155 @@
+/*
+  This file is part of KDDockWidgets.
+
+  SPDX-FileCopyrightText: 2019-2020 Klarälvdalens Datakonsult AB, a KDAB Group company <info@kdab.com>
+  Author: Sérgio Martins <sergio.martins@kdab.com>
+
+  SPDX-License-Identifier: GPL-2.0-only OR GPL-3.0-only
+
+  Contact KDAB at <info@kdab.com> for commercial licensing options.
+*/
+
+/**
+ * @file
+ * @brief Keeps hidden FloatingWindows around, so floating a dock widget doesn't need to create a new window.
+ *
+ * @author Sérgio Martins \<sergio.martins@kdab.com\>
+ */
+
+#include "FloatingWindowPool_p.h"
+#include "FloatingWindow_p.h"
+#include "DockRegistry_p.h"
+#include "Logging_p.h"
+#include "MainWindowBase.h"
+#include "Config.h"
+#include "FrameworkWidgetFactory.h"
+
+#include <QCoreApplication>
+
+using namespace KDDockWidgets;
+
+FloatingWindowPool::FloatingWindowPool(QObject *parent)
+    : QObject(parent)
+{
+    m_idleTimer.setSingleShot(true);
+    m_idleTimer.setInterval(0);
+    connect(&m_idleTimer, &QTimer::timeout, this, &FloatingWindowPool::onIdle);
+}
+
+FloatingWindowPool::~FloatingWindowPool()
+{
+    for (const QPointer<FloatingWindow> &fw : qAsConst(m_windows))
+        delete fw;
+}
+
+FloatingWindowPool *FloatingWindowPool::self()
+{
+    static QPointer<FloatingWindowPool> s_pool;
+
+    if (!s_pool)
+        s_pool = new FloatingWindowPool(qApp);
+
+    return s_pool;
+}
+
+FloatingWindow *FloatingWindowPool::take(Frame *frame, MainWindowBase *parent)
+{
+    if (capacity() == 0)
+        return nullptr;
+
+    scheduleIdleWork();
+
+    FloatingWindow *fw = nullptr;
+    while (!fw && !m_windows.isEmpty()) {
+        // Might be null, if the main window it was parented to got deleted
+        fw = m_windows.takeLast();
+    }
+
+    if (!fw) {
+        qCDebug(creation) << Q_FUNC_INFO << "Pool is empty";
+        return nullptr;
+    }
+
+    fw->leavePool(frame, parent);
+    return fw;
+}
+
+bool FloatingWindowPool::recycleLater(FloatingWindow *fw)
+{
+    if (m_pendingRecycle.contains(fw))
+        return true;
+
+    if (m_windows.size() + m_pendingRecycle.size() >= capacity())
+        return false;
+
+    m_pendingRecycle.push_back(fw);
+    scheduleIdleWork();
+    return true;
+}
+
+int FloatingWindowPool::size() const
+{
+    return m_windows.size();
+}
+
+bool FloatingWindowPool::contains(FloatingWindow *fw) const
+{
+    return fw && m_windows.contains(fw);
+}
+
+void FloatingWindowPool::updateSize()
+{
+    m_windows.removeAll(nullptr);
+
+    const int max = capacity();
+    while (m_windows.size() > max)
+        delete m_windows.takeFirst();
+
+    scheduleIdleWork();
+}
+
+void FloatingWindowPool::scheduleIdleWork()
+{
+    if (!m_idleTimer.isActive())
+        m_idleTimer.start();
+}
+
+void FloatingWindowPool::onIdle()
+{
+    const int max = capacity();
+
+    const QVector<QPointer<FloatingWindow>> pending = m_pendingRecycle;
+    m_pendingRecycle.clear();
+    for (FloatingWindow *fw : pending) {
+        if (!fw)
+            continue;
+
+        if (m_windows.size() < max && fw->isRecyclable()) {
+            fw->enterPool();
+            m_windows.push_back(fw);
+        } else {
+            fw->deleteLater();
+        }
+    }
+
+    m_windows.removeAll(nullptr);
+    if (m_windows.size() >= max)
+        return;
+
+    // Parent to the main window, if there's only one. Otherwise the window is reparented once
+    // we know which frame it will hold, and therefore its affinities.
+    const MainWindowBase::List mainWindows = DockRegistry::self()->mainwindows();
+    MainWindowBase *parent = mainWindows.size() == 1 ? mainWindows.constFirst() : nullptr;
+
+    qCDebug(creation) << Q_FUNC_INFO << "Creating" << (max - m_windows.size()) << "windows";
+    while (m_windows.size() < max) {
+        FloatingWindow *fw = Config::self().frameworkWidgetFactory()->createFloatingWindow(parent);
+        fw->enterPool();
+        m_windows.push_back(fw);
+    }
+}
+
+int FloatingWindowPool::capacity() const
+{
+    return Config::self().floatingWindowPoolSize();
+}
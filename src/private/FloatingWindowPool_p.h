@@ -0,0 +1,87 @@
+/*
+  This file is part of KDDockWidgets.
+
+  SPDX-FileCopyrightText: 2019-2020 Klarälvdalens Datakonsult AB, a KDAB Group company <info@kdab.com>
+  Author: Sérgio Martins <sergio.martins@kdab.com>
+
+  SPDX-License-Identifier: GPL-2.0-only OR GPL-3.0-only
+
+  Contact KDAB at <info@kdab.com> for commercial licensing options.
+*/
+
+/**
+ * @file
+ * @brief Keeps hidden FloatingWindows around, so floating a dock widget doesn't need to create a new window.
+ *
+ * @author Sérgio Martins \<sergio.martins@kdab.com\>
+ */
+
+#ifndef KD_FLOATINGWINDOWPOOL_P_H
+#define KD_FLOATINGWINDOWPOOL_P_H
+
+#include "docks_export.h"
+
+#include <QObject>
+#include <QPointer>
+#include <QTimer>
+#include <QVector>
+
+namespace KDDockWidgets {
+
+class FloatingWindow;
+class Frame;
+class MainWindowBase;
+
+/**
+ * @brief A bounded pool of hidden FloatingWindows, with their native window already created.
+ *
+ * Creating a top-level window is the most expensive part of floating a dock widget. When
+ * Config::setFloatingWindowPoolSize() is > 0, DefaultWidgetFactory takes windows from here and
+ * FloatingWindows which became empty are put back instead of being deleted.
+ *
+ * The pool is topped up when the event loop is idle, so the cost isn't paid while dragging.
+ * Only used with QtWidgets.
+ */
+class DOCKS_EXPORT FloatingWindowPool : public QObject
+{
+    Q_OBJECT
+public:
+    static FloatingWindowPool *self();
+    ~FloatingWindowPool() override;
+
+    /**
+     * @brief Returns a pooled window, now holding @p frame, or nullptr if the pool is empty.
+     * @param parent the parent suggested to FloatingWindow's constructor
+     */
+    FloatingWindow *take(Frame *frame, MainWindowBase *parent);
+
+    /**
+     * @brief Called when @p fw became empty. It will be put back into the pool once control
+     * returns to the event loop, like deleteLater() would do.
+     * Returns false if the pool is full, in which case the caller should delete it.
+     */
+    bool recycleLater(FloatingWindow *fw);
+
+    ///@brief returns the number of windows ready to be reused
+    int size() const;
+
+    ///@brief returns whether @p fw is waiting in the pool
+    bool contains(FloatingWindow *fw) const;
+
+    ///@brief Deletes the windows exceeding Config::floatingWindowPoolSize() and schedules a top-up
+    void updateSize();
+
+private:
+    explicit FloatingWindowPool(QObject *parent);
+    void scheduleIdleWork();
+    void onIdle();
+    int capacity() const;
+
+    QVector<QPointer<FloatingWindow>> m_windows;
+    QVector<QPointer<FloatingWindow>> m_pendingRecycle;
+    QTimer m_idleTimer;
+};
+
+}
+
+#endif
@@ -31,6 +31,7 @@ class MainWindowBase;
 class DropArea;
 class Frame;
 class MultiSplitter;
+class FloatingWindowPool;
 
 class DOCKS_EXPORT FloatingWindow
         : public QWidgetAdapter
@@ -99,11 +100,13 @@ public:
 
     /**
      * @brief Returns whether a deleteLater has already been issued
+     * Also true while the window is waiting in FloatingWindowPool.
      */
     bool beingDeleted() const;
 
     /**
      * @brief Equivalent to deleteLater() but sets beingDeleted() to true
+     * With Config::setFloatingWindowPoolSize() the window might be recycled instead.
      */
     void scheduleDeleteLater();
 
@@ -150,10 +153,23 @@ protected:
     TitleBar *const m_titleBar;
 private:
     Q_DISABLE_COPY(FloatingWindow)
+    friend class FloatingWindowPool;
+    void addFirstFrame(Frame *frame);
+#ifdef KDDOCKWIDGETS_QTWIDGETS
+    ///@brief returns whether this window is empty and can be put into FloatingWindowPool
+    bool isRecyclable() const;
+
+    ///@brief hides and resets this window, which is now owned by FloatingWindowPool
+    void enterPool();
+
+    ///@brief makes this window usable again, holding @p frame
+    void leavePool(Frame *frame, MainWindowBase *candidateParent);
+#endif
     void onFrameCountChanged(int count);
     void onVisibleFrameCountChanged(int count);
     bool m_disableSetVisible = false;
     bool m_deleteScheduled = false;
+    bool m_pooled = false;
     bool m_inDtor = false;
     bool m_updatingTitleBarVisibility = false;
     QMetaObject::Connection m_layoutDestroyedConnection;
@@ -27,6 +27,10 @@
 #include "TitleBar_p.h"
 #include "FrameworkWidgetFactory.h"
 
+#ifdef KDDOCKWIDGETS_QTWIDGETS
+# include "FramePool_p.h"
+#endif
+
 #include <QCloseEvent>
 #include <QTimer>
 
@@ -77,6 +81,7 @@ Frame::~Frame()
 
 void Frame::updateTitleAndIcon()
 {
+    m_titleAndIconDirty = false;
     if (DockWidgetBase *dw = currentDockWidget()) {
         m_titleBar->setTitle(dw->title());
         m_titleBar->setIcon(dw->icon());
@@ -94,9 +99,55 @@ void Frame::updateTitleAndIcon()
     }
 }
 
+void Frame::scheduleTitleAndIconUpdate()
+{
+    if (m_titleAndIconDirty) {
+        // Already pending, will be handled by the same updateTitleAndIcon() call
+        m_numCoalescedUpdates++;
+        return;
+    }
+
+    m_titleAndIconDirty = true;
+    QTimer::singleShot(0, this, [this] {
+        if (m_titleAndIconDirty)
+            updateTitleAndIcon();
+    });
+}
+
+void Frame::scheduleSizeConstraintsUpdate()
+{
+    if (m_inDtor)
+        return;
+
+    // Invalidate right away, so queries done meanwhile aren't stale
+    for (DockWidgetBase *dw : dockWidgets())
+        dw->invalidateCachedSizes();
+
+    if (m_sizeConstraintsDirty)
+        return;
+
+    m_sizeConstraintsDirty = true;
+    DockRegistry::self()->scheduleSizeConstraintsUpdate(this);
+}
+
+void Frame::updateSizeConstraints()
+{
+    if (!m_sizeConstraintsDirty)
+        return;
+
+    m_sizeConstraintsDirty = false;
+    Q_EMIT layoutInvalidated();
+}
+
+int Frame::dbg_numCoalescedUpdates() const
+{
+    return m_numCoalescedUpdates;
+}
+
 void Frame::onDockWidgetTitleChanged()
 {
-    updateTitleAndIcon();
+    // Titles can change several times per second, update the title bars once per event loop iteration
+    scheduleTitleAndIconUpdate();
 
     if (!m_inCtor) { // don't call pure virtual in ctor
         if (auto dw = qobject_cast<DockWidgetBase*>(sender()))
@@ -143,6 +194,7 @@ void Frame::insertWidget(DockWidgetBase *dockWidget, int index, AddingOption add
         dockWidget->addPlaceholderItem(m_layoutItem);
 
     insertDockWidget(dockWidget, index);
+    dockWidget->updateFloatAction();
 
     if (addingOption == AddingOption_StartHidden) {
         dockWidget->close(); // Ensure closed
@@ -251,7 +303,10 @@ int Frame::dockWidgetCount() const
 void Frame::onDockWidgetCountChanged()
 {
     qCDebug(docking) << "Frame::onDockWidgetCountChanged:" << this << "; widgetCount=" << dockWidgetCount();
-    if (isEmpty() && !isCentralFrame()) {
+    invalidateDockWidgetsCache();
+
+    // The overlay frame is reused by MainWindowBase, it's only hidden when empty
+    if (isEmpty() && !isCentralFrame() && !isOverlayed()) {
         scheduleDeleteLater();
     } else {
         updateTitleBarVisibility();
@@ -260,9 +315,13 @@ void Frame::onDockWidgetCountChanged()
         if (!(m_options & FrameOption_AlwaysShowsTabs))
             Q_EMIT hasTabsVisibleChanged();
 
-        const DockWidgetBase::List docks = dockWidgets();
-        for (DockWidgetBase *dock : docks)
-            dock->updateFloatAction();
+        // With more than 2 dock widgets none of them can be floating, nor was before the change.
+        // The dock widget being added is updated by insertWidget(), so adding isn't O(n).
+        if (dockWidgetCount() <= 2) {
+            const DockWidgetBase::List docks = dockWidgets();
+            for (DockWidgetBase *dock : docks)
+                dock->updateFloatAction();
+        }
     }
 
     Q_EMIT numDockWidgetsChanged();
@@ -272,6 +331,9 @@ void Frame::onCurrentTabChanged(int index)
 {
     if (index != -1) {
         if (auto dock = dockWidgetAt(index)) {
+            // Create a lazy guest before it's shown, so it's already there when painting
+            if (isVisible())
+                dock->maybeCreateWidget();
             Q_EMIT currentDockWidgetChanged(dock);
         } else {
             qWarning() << "dockWidgetAt" << index << "returned nullptr" << this;
@@ -351,24 +413,29 @@ const DockWidgetBase::List Frame::dockWidgets() const
     if (m_inCtor || m_inDtor)
         return {};
 
-    DockWidgetBase::List dockWidgets;
+    // Called very often, and with many tabs building the list each time is noticeable.
+    // The count is also compared, as tabs can be removed before onDockWidgetCountChanged() is called.
     const int count = dockWidgetCount();
-    dockWidgets.reserve(count);
-    for (int i = 0, e = count; i != e; ++i) {
-        dockWidgets << dockWidgetAt(i);
+    if (m_dockWidgetsCacheDirty || m_dockWidgetsCache.size() != count) {
+        m_dockWidgetsCache.clear();
+        m_dockWidgetsCache.reserve(count);
+        for (int i = 0, e = count; i != e; ++i) {
+            m_dockWidgetsCache << dockWidgetAt(i);
+        }
+        m_dockWidgetsCacheDirty = false;
     }
 
-    return dockWidgets;
+    return m_dockWidgetsCache;
+}
+
+void Frame::invalidateDockWidgetsCache()
+{
+    m_dockWidgetsCacheDirty = true;
 }
 
 bool Frame::containsDockWidget(DockWidgetBase *dockWidget) const
 {
-    const int count = dockWidgetCount();
-    for (int i = 0, e = count; i != e; ++i) {
-        if (dockWidget == dockWidgetAt(i))
-            return true;
-    }
-    return false;
+    return dockWidgets().contains(dockWidget);
 }
 
 FloatingWindow *Frame::floatingWindow() const
@@ -641,16 +708,73 @@ void Frame::scheduleDeleteLater()
     qCDebug(creation) << Q_FUNC_INFO << this;
     m_beingDeleted = true;
     QTimer::singleShot(0, this, [this] {
+        // Already recycled, or taken from the pool again meanwhile
+        if (m_pooled || !m_beingDeleted)
+            return;
+
         // Can't use deleteLater() here due to QTBUG-83030 (deleteLater() never delivered if triggered by a sendEvent() before event loop starts)
-        delete this;
+        recycleOrDelete();
     });
 }
 
+void Frame::recycleOrDelete()
+{
+#ifdef KDDOCKWIDGETS_QTWIDGETS
+    if (Config::self().framePoolSize() > 0 && FramePool::self()->recycle(this))
+        return;
+#endif
+
+    delete this;
+}
+
+#ifdef KDDOCKWIDGETS_QTWIDGETS
+bool Frame::isRecyclable() const
+{
+    return !m_pooled && !m_inDtor && isEmpty() && m_options == actualOptions(FrameOption_None);
+}
+
+void Frame::enterPool()
+{
+    qCDebug(creation) << Q_FUNC_INFO << this;
+    m_pooled = true;
+    m_beingDeleted = true;
+
+    // Do to the layout what the destructor and QObject::destroyed() would do
+    QPointer<Layouting::Item> item = m_layoutItem;
+    m_layoutItem = nullptr;
+    if (item)
+        item->unref();
+    if (item && item->guestAsQObject() == static_cast<QObject *>(this))
+        item->releaseGuestWidget();
+
+    DockRegistry::self()->unregisterFrame(this);
+    setDropArea(nullptr);
+    onFocusObjectChanged(nullptr, false);
+
+    QWidgetAdapter::hide();
+    QWidgetAdapter::setParent(nullptr);
+    m_titleBar->setTitle(QString());
+    m_titleBar->setIcon(QIcon());
+    setObjectName(QString());
+}
+
+void Frame::leavePool(QWidgetOrQuick *parent)
+{
+    qCDebug(creation) << Q_FUNC_INFO << this << parent;
+    m_pooled = false;
+    m_beingDeleted = false;
+
+    QWidgetAdapter::setParent(parent);
+    DockRegistry::self()->registerFrame(this);
+    setDropArea(qobject_cast<DropArea *>(QWidgetAdapter::parentWidget()));
+}
+#endif
+
 QSize Frame::dockWidgetsMinSize() const
 {
     QSize size = Layouting::Item::hardcodedMinimumSize;
     for (DockWidgetBase *dw : dockWidgets())
-        size = size.expandedTo(Layouting::Widget::widgetMinSize(dw));
+        size = size.expandedTo(dw->cachedMinSize());
 
     return size;
 }
@@ -659,7 +783,7 @@ QSize Frame::biggestDockWidgetMaxSize() const
 {
     QSize size = Layouting::Item::hardcodedMaximumSize;
     for (DockWidgetBase *dw : dockWidgets()) {
-        const QSize dwMax = widgetMaxSize(dw);
+        const QSize dwMax = dw->cachedMaxSize();
         if (size == Layouting::Item::hardcodedMaximumSize) {
             size = dwMax;
             continue;
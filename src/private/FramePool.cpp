@@ -0,0 +1,110 @@
+/*
+  This file is part of KDDockWidgets.
+
+  SPDX-FileCopyrightText: 2019-2020 Klarälvdalens Datakonsult AB, a KDAB Group company <info@kdab.com>
+  Author: Sérgio Martins <sergio.martins@kdab.com>
+
+  SPDX-License-Identifier: GPL-2.0-only OR GPL-3.0-only
+
+  Contact KDAB at <info@kdab.com> for commercial licensing options.
+*/
+
+/**
+ * @file
+ * @brief Keeps empty Frames around, so docking doesn't need to create new ones.
+ *
+ * @author Sérgio Martins \<sergio.martins@kdab.com\>
+ */
+
+#include "FramePool_p.h"
+#include "Frame_p.h"
+#include "Logging_p.h"
+#include "Config.h"
+
+#include <QCoreApplication>
+
+using namespace KDDockWidgets;
+
+FramePool::FramePool(QObject *parent)
+    : QObject(parent)
+{
+}
+
+FramePool::~FramePool()
+{
+    for (const QPointer<Frame> &frame : qAsConst(m_frames))
+        delete frame;
+}
+
+FramePool *FramePool::self()
+{
+    static QPointer<FramePool> s_pool;
+
+    if (!s_pool)
+        s_pool = new FramePool(qApp);
+
+    return s_pool;
+}
+
+Frame *FramePool::take(QWidgetOrQuick *parent)
+{
+    Frame *frame = nullptr;
+    while (!frame && !m_frames.isEmpty()) {
+        // Might be null, if something deleted it behind our back
+        frame = m_frames.takeLast();
+    }
+
+    if (!frame) {
+        m_misses++;
+        qCDebug(creation) << Q_FUNC_INFO << "Pool is empty; misses=" << m_misses;
+        return nullptr;
+    }
+
+    m_hits++;
+    frame->leavePool(parent);
+    return frame;
+}
+
+bool FramePool::recycle(Frame *frame)
+{
+    if (!frame->isRecyclable())
+        return false;
+
+    m_frames.removeAll(nullptr);
+    if (m_frames.size() >= Config::self().framePoolSize())
+        return false;
+
+    frame->enterPool();
+    m_frames.push_back(frame);
+    return true;
+}
+
+int FramePool::size() const
+{
+    return m_frames.size();
+}
+
+int FramePool::hits() const
+{
+    return m_hits;
+}
+
+int FramePool::misses() const
+{
+    return m_misses;
+}
+
+void FramePool::resetStatistics()
+{
+    m_hits = 0;
+    m_misses = 0;
+}
+
+void FramePool::updateSize()
+{
+    m_frames.removeAll(nullptr);
+
+    const int max = Config::self().framePoolSize();
+    while (m_frames.size() > max)
+        delete m_frames.takeFirst();
+}
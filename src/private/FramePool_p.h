@@ -0,0 +1,77 @@
+/*
+  This file is part of KDDockWidgets.
+
+  SPDX-FileCopyrightText: 2019-2020 Klarälvdalens Datakonsult AB, a KDAB Group company <info@kdab.com>
+  Author: Sérgio Martins <sergio.martins@kdab.com>
+
+  SPDX-License-Identifier: GPL-2.0-only OR GPL-3.0-only
+
+  Contact KDAB at <info@kdab.com> for commercial licensing options.
+*/
+
+/**
+ * @file
+ * @brief Keeps empty Frames around, so docking doesn't need to create new ones.
+ *
+ * @author Sérgio Martins \<sergio.martins@kdab.com\>
+ */
+
+#ifndef KD_FRAMEPOOL_P_H
+#define KD_FRAMEPOOL_P_H
+
+#include "docks_export.h"
+#include "QWidgetAdapter.h"
+
+#include <QObject>
+#include <QPointer>
+#include <QVector>
+
+namespace KDDockWidgets {
+
+class Frame;
+
+/**
+ * @brief A bounded pool of empty Frames, each with its TitleBar and TabWidget already created.
+ *
+ * When Config::setFramePoolSize() is > 0, Frames which became empty are reset and put here instead
+ * of being deleted, and DefaultWidgetFactory::createFrame() takes them from here.
+ * Only Frames without special options (central, overlayed) are pooled. Only used with QtWidgets.
+ */
+class DOCKS_EXPORT FramePool : public QObject
+{
+    Q_OBJECT
+public:
+    static FramePool *self();
+    ~FramePool() override;
+
+    ///@brief Returns a pooled Frame, reparented to @p parent, or nullptr if the pool is empty
+    Frame *take(QWidgetOrQuick *parent);
+
+    ///@brief Resets @p frame and keeps it for reuse. Returns false if the pool is full, in which case the caller deletes it
+    bool recycle(Frame *frame);
+
+    ///@brief returns the number of Frames ready to be reused
+    int size() const;
+
+    ///@brief returns how many times take() returned a pooled Frame
+    int hits() const;
+
+    ///@brief returns how many times take() found the pool empty, so a new Frame had to be created
+    int misses() const;
+
+    ///@brief sets hits() and misses() back to 0
+    void resetStatistics();
+
+    ///@brief Deletes the Frames exceeding Config::framePoolSize()
+    void updateSize();
+
+private:
+    explicit FramePool(QObject *parent);
+    QVector<QPointer<Frame>> m_frames;
+    int m_hits = 0;
+    int m_misses = 0;
+};
+
+}
+
+#endif
@@ -106,6 +106,18 @@ public:
     int dockWidgetCount() const;
 
     void updateTitleAndIcon();
+
+    /**
+     * @brief Called when the size constraints of this frame, or of its dock widgets, might have changed.
+     *
+     * Discards the sizes cached by the dock widgets and emits layoutInvalidated() once control
+     * returns to the event loop, so bursts of layout requests only propagate once.
+     */
+    void scheduleSizeConstraintsUpdate();
+
+    ///@brief Marks the title and icon as dirty. updateTitleAndIcon() is called once control returns to the event loop.
+    void scheduleTitleAndIconUpdate();
+
     void onDockWidgetTitleChanged();
     void updateTitleBarVisibility();
     void updateFloatingActions();
@@ -211,6 +223,9 @@ public:
     ///@brief For tests-only. Returns the number of Frame instances in the whole application.
     static int dbg_numFrames();
 
+    ///@brief For debugging purposes. Returns how many title and icon updates were merged into an already pending one.
+    int dbg_numCoalescedUpdates() const;
+
     /**
      * @brief Returns whether a deleteLater has already been issued
      */
@@ -284,8 +299,31 @@ private:
     Q_DISABLE_COPY(Frame)
     friend class ::TestDocks;
     friend class TabWidget;
+    friend class FramePool;
+    friend class DockRegistry;
     void onCurrentTabChanged(int index);
     void scheduleDeleteLater();
+
+    ///@brief dockWidgets() will query the tabs again. Called when tabs are added, removed or moved.
+    void invalidateDockWidgetsCache();
+
+    ///@brief emits layoutInvalidated(), if scheduleSizeConstraintsUpdate() was called
+    void updateSizeConstraints();
+
+    ///@brief deletes this empty Frame, or puts it into FramePool if Config::framePoolSize() allows
+    void recycleOrDelete();
+
+#ifdef KDDOCKWIDGETS_QTWIDGETS
+    ///@brief returns whether this Frame is empty and can be put into FramePool
+    bool isRecyclable() const;
+
+    ///@brief removes this Frame from its layout and resets it, it's now owned by FramePool
+    void enterPool();
+
+    ///@brief makes a pooled Frame usable again, as if it had just been constructed with @p parent
+    void leavePool(QWidgetOrQuick *parent);
+#endif
+
     bool event(QEvent *) override;
     bool m_inCtor = true;
     TitleBar *const m_titleBar;
@@ -294,6 +332,12 @@ private:
     QPointer<Layouting::Item> m_layoutItem;
     bool m_updatingTitleBar = false;
     bool m_beingDeleted = false;
+    bool m_pooled = false;
+    bool m_titleAndIconDirty = false;
+    bool m_sizeConstraintsDirty = false;
+    int m_numCoalescedUpdates = 0;
+    mutable DockWidgetBase::List m_dockWidgetsCache;
+    mutable bool m_dockWidgetsCacheDirty = true;
     QMetaObject::Connection m_visibleWidgetCountChangedConnection;
 };
 
@@ -20,6 +20,7 @@ Q_LOGGING_CATEGORY(docking, "kdab.docks.docking", QtWarningMsg)
 Q_LOGGING_CATEGORY(hiding, "kdab.docks.hiding", QtWarningMsg)
 Q_LOGGING_CATEGORY(closing, "kdab.docks.closing", QtWarningMsg)
 Q_LOGGING_CATEGORY(dropping, "kdab.docks.dropping", QtWarningMsg)
+Q_LOGGING_CATEGORY(dragstatistics, "kdab.docks.dragstatistics", QtWarningMsg)
 Q_LOGGING_CATEGORY(sizing, "kdab.multisplitter.sizing", QtWarningMsg)
 Q_LOGGING_CATEGORY(addwidget, "kdab.multisplitter.addwidget", QtWarningMsg)
 Q_LOGGING_CATEGORY(placeholder, "kdab.multisplitter.placeholder", QtWarningMsg)
@@ -34,5 +34,6 @@ Q_DECLARE_LOGGING_CATEGORY(anchors)
 Q_DECLARE_LOGGING_CATEGORY(item)
 Q_DECLARE_LOGGING_CATEGORY(placeholder)
 Q_DECLARE_LOGGING_CATEGORY(toplevels)
+Q_DECLARE_LOGGING_CATEGORY(dragstatistics)
 
 #endif
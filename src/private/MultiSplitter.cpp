@@ -33,7 +33,11 @@
 #include "DropArea_p.h"
 #include "WindowBeingDragged_p.h"
 
+#include <QPointer>
 #include <QScopedValueRollback>
+#include <QSet>
+
+#include <algorithm>
 
 using namespace KDDockWidgets;
 
@@ -57,9 +61,26 @@ MultiSplitter::MultiSplitter(QWidgetOrQuick *parent)
 MultiSplitter::~MultiSplitter()
 {
     qCDebug(creation) << "~MultiSplitter" << this;
-    if (m_rootItem->hostWidget()->asQObject() == this)
-        delete m_rootItem;
     DockRegistry::self()->unregisterLayout(this);
+
+    if (m_rootItem->hostWidget()->asQObject() == this) {
+        tearDown();
+        delete m_rootItem;
+    }
+}
+
+void MultiSplitter::tearDown()
+{
+    const Frame::List frames = this->frames();
+    if (frames.isEmpty())
+        return;
+
+    m_rootItem->setIsTearingDown(true);
+
+    DockRegistry *registry = DockRegistry::self();
+    registry->beginTeardown(frames);
+    qDeleteAll(frames);
+    registry->endTeardown(); // Might delete the registry, don't use it after this
 }
 
 void MultiSplitter::onLayoutRequest()
@@ -390,6 +411,72 @@ void MultiSplitter::unrefOldPlaceholders(const Frame::List &framesBeingAdded) co
     }
 }
 
+int MultiSplitter::compactPlaceholders()
+{
+    if (LayoutSaver::restoreInProgress())
+        return 0;
+
+    const DockWidgetBase::List dockWidgets = DockRegistry::self()->dockwidgets();
+
+    // Showing a dock widget only restores it to the item returned by Position::layoutItem().
+    // Any other placeholder is just dead weight.
+    QSet<Layouting::Item*> restorableItems;
+    restorableItems.reserve(dockWidgets.size());
+    for (DockWidgetBase *dw : dockWidgets) {
+        if (Layouting::Item *item = dw->lastPositions().lastItem())
+            restorableItems.insert(item);
+    }
+
+    const qint64 maxAge = Config::self().maxPlaceholderAge();
+    const int maxCount = Config::self().maxPlaceholderCount();
+
+    Layouting::Item::List toRemove;
+    QVector<QPair<qint64, Layouting::Item*>> candidates;
+    const Layouting::Item::List allItems = items();
+    for (Layouting::Item *item : allItems) {
+        if (!item->isPlaceholder())
+            continue;
+
+        const qint64 age = item->placeholderAge();
+        if (!restorableItems.contains(item) || (maxAge > 0 && age > maxAge)) {
+            toRemove.push_back(item);
+        } else {
+            candidates.push_back({ age, item });
+        }
+    }
+
+    if (maxCount > 0 && candidates.size() > maxCount) {
+        // Keep the most recent ones
+        std::sort(candidates.begin(), candidates.end(), [] (const QPair<qint64, Layouting::Item*> &a,
+                                                           const QPair<qint64, Layouting::Item*> &b) {
+            return a.first > b.first;
+        });
+
+        for (int i = 0, end = candidates.size() - maxCount; i < end; ++i)
+            toRemove.push_back(candidates.at(i).second);
+    }
+
+    if (toRemove.isEmpty())
+        return 0;
+
+    qCDebug(placeholder) << Q_FUNC_INFO << "Removing" << toRemove.size() << "placeholders";
+
+    for (Layouting::Item *item : qAsConst(toRemove)) {
+        // The item is deleted once the last dock widget referencing it drops it
+        QPointer<Layouting::Item> guard = item;
+        for (DockWidgetBase *dw : dockWidgets) {
+            if (!guard)
+                break;
+            dw->lastPositions().removePlaceholder(item);
+        }
+    }
+
+    m_rootItem->simplify();
+    updateSizeConstraints();
+
+    return toRemove.size();
+}
+
 void MultiSplitter::dumpLayout() const
 {
     m_rootItem->dumpLayout();
@@ -468,10 +555,11 @@ bool MultiSplitter::deserialize(const LayoutSaver::MultiSplitter &l)
 {
     setRootItem(new Layouting::ItemContainer(this));
 
-    QHash<QString, Layouting::Widget*> frames;
+    QHash<qint64, Layouting::Widget*> frames;
+    frames.reserve(l.frames.size());
     for (const LayoutSaver::Frame &frame : qAsConst(l.frames)) {
         Frame *f = Frame::deserialize(frame);
-        Q_ASSERT(!frame.id.isEmpty());
+        Q_ASSERT(frame.id > 0);
         frames.insert(frame.id, f);
     }
 
@@ -209,6 +209,14 @@ public:
     /// @brief clears the layout
     void clearLayout();
 
+    /**
+     * @brief Removes placeholders which can't be restored anymore, and the ones exceeding the
+     * limits set with Config::setMaxPlaceholderCount() and Config::setMaxPlaceholderAge().
+     * Then removes any nesting which became redundant.
+     * @return the number of placeholders removed
+     */
+    int compactPlaceholders();
+
 Q_SIGNALS:
     void visibleWidgetCountChanged(int count);
 
@@ -229,6 +237,15 @@ private:
 
     Layouting::ItemContainer *rootItem() const;
 
+    /**
+     * @brief Deletes all frames, called when the layout itself is being destroyed.
+     *
+     * The Item tree is marked as tearing down first, so the frames going away don't
+     * turn into placeholders or relayout their neighbours one by one. The frames and their dock
+     * widgets are also unregistered from DockRegistry in a single pass.
+     */
+    void tearDown();
+
     // For debug/hardening
     bool validateInputs(QWidgetOrQuick *widget, KDDockWidgets::Location location,
                         const Frame *relativeToFrame, AddingOption option) const;
@@ -178,6 +178,10 @@ struct LastPositions
         lastPosition->removePlaceholders(hostWidget);
     }
 
+    void removePlaceholder(Layouting::Item *placeholder) const {
+        lastPosition->removePlaceholder(placeholder);
+    }
+
     int lastTabIndex() const {
         return lastPosition->m_tabIndex;
     }
@@ -31,16 +31,16 @@ TitleBar::TitleBar(Frame *parent)
     , m_floatingWindow(nullptr)
     , m_supportsAutoHide(Config::self().flags() & Config::Flag_AutoHideSupport)
 {
-    connect(m_frame, &Frame::numDockWidgetsChanged, this, &TitleBar::updateCloseButton);
+    connect(m_frame, &Frame::numDockWidgetsChanged, this, &TitleBar::scheduleButtonsUpdate);
     connect(m_frame, &Frame::isFocusedChanged, this, &TitleBar::isFocusedChanged);
-    connect(m_frame, &Frame::isInMainWindowChanged, this, &TitleBar::updateAutoHideButton);
+    connect(m_frame, &Frame::isInMainWindowChanged, this, &TitleBar::scheduleButtonsUpdate);
 
     init();
 
     if (Config::self().flags() & Config::Flag_TitleBarIsFocusable)
         setFocusPolicy(Qt::StrongFocus);
 
-    QTimer::singleShot(0, this, &TitleBar::updateAutoHideButton); // have to wait after the frame is constructed
+    scheduleButtonsUpdate(); // have to wait after the frame is constructed
     updateAutoHideButton();
 }
 
@@ -51,11 +51,8 @@ TitleBar::TitleBar(FloatingWindow *parent)
     , m_floatingWindow(parent)
     , m_supportsAutoHide(Config::self().flags() & Config::Flag_AutoHideSupport)
 {
-    connect(m_floatingWindow, &FloatingWindow::numFramesChanged, this, &TitleBar::updateCloseButton);
-    connect(m_floatingWindow, &FloatingWindow::numFramesChanged, this, &TitleBar::updateFloatButton);
-    connect(m_floatingWindow, &FloatingWindow::numFramesChanged, this, &TitleBar::updateMaximizeButton);
-    connect(m_floatingWindow, &FloatingWindow::numFramesChanged, this, &TitleBar::updateMinimizeButton);
-    connect(m_floatingWindow, &FloatingWindow::windowStateChanged, this, &TitleBar::updateMaximizeButton);
+    connect(m_floatingWindow, &FloatingWindow::numFramesChanged, this, &TitleBar::scheduleButtonsUpdate);
+    connect(m_floatingWindow, &FloatingWindow::windowStateChanged, this, &TitleBar::scheduleButtonsUpdate);
     connect(m_floatingWindow, &FloatingWindow::activatedChanged , this, &TitleBar::isFocusedChanged);
     init();
     updateAutoHideButton(); // always hidden when we're in a FloatingWindow.
@@ -91,6 +88,40 @@ bool TitleBar::onDoubleClicked()
     return false;
 }
 
+void TitleBar::scheduleButtonsUpdate()
+{
+    if (m_buttonsDirty) {
+        // Already pending, will be handled by the same updateButtons() call
+        m_numCoalescedUpdates++;
+        return;
+    }
+
+    m_buttonsDirty = true;
+    QTimer::singleShot(0, this, &TitleBar::updateButtons);
+}
+
+void TitleBar::updateButtons()
+{
+    if (!m_buttonsDirty)
+        return;
+
+    m_buttonsDirty = false;
+    updateCloseButton();
+
+    if (m_floatingWindow) {
+        updateFloatButton();
+        updateMaximizeButton();
+        updateMinimizeButton();
+    } else {
+        updateAutoHideButton();
+    }
+}
+
+int TitleBar::dbg_numCoalescedUpdates() const
+{
+    return m_numCoalescedUpdates;
+}
+
 void TitleBar::updateCloseButton()
 {
 
@@ -163,6 +194,9 @@ void TitleBar::setTitle(const QString &title)
 
 void TitleBar::setIcon(const QIcon &icon)
 {
+    if (icon.cacheKey() == m_icon.cacheKey())
+        return;
+
     m_icon = icon;
     Q_EMIT iconChanged();
 }
@@ -209,6 +243,15 @@ std::unique_ptr<WindowBeingDragged> TitleBar::makeWindow()
     return std::unique_ptr<WindowBeingDragged>(new WindowBeingDragged(floatingWindow, draggable));
 }
 
+bool TitleBar::makeWindowDetaches() const
+{
+    if (m_floatingWindow || !m_frame)
+        return false;
+
+    // The only frame of a floating window drags the whole window, see makeWindow()
+    return !(QWidgetAdapter::floatingWindow() && m_frame->isTheOnlyFrame());
+}
+
 DockWidgetBase *TitleBar::singleDockWidget() const
 {
     const DockWidgetBase::List dockWidgets = this->dockWidgets();
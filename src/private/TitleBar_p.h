@@ -56,6 +56,7 @@ public:
 
     void setIcon(const QIcon &icon);
     std::unique_ptr<WindowBeingDragged> makeWindow() override;
+    bool makeWindowDetaches() const override;
 
     DockWidgetBase *singleDockWidget() const override;
 
@@ -101,6 +102,9 @@ public:
     /// @brief updates the close button enabled state
     void updateCloseButton();
 
+    ///@brief For debugging purposes. Returns how many button updates were merged into an already pending one.
+    int dbg_numCoalescedUpdates() const;
+
 Q_SIGNALS:
     void titleChanged();
     void iconChanged();
@@ -127,6 +131,12 @@ protected:
     virtual void updateMinimizeButton() {}
     virtual void updateAutoHideButton() {}
 
+    ///@brief Marks the buttons as dirty. They are updated once control returns to the event loop.
+    void scheduleButtonsUpdate();
+
+    ///@brief Updates the buttons now, if they are dirty
+    void updateButtons();
+
 #ifdef DOCKS_DEVELOPER_MODE
     // The following are needed for the unit-tests
     virtual bool isCloseButtonVisible() const = 0;
@@ -156,6 +166,8 @@ private:
     bool m_closeButtonEnabled = true;
     bool m_floatButtonVisible = true;
     QString m_floatButtonToolTip;
+    bool m_buttonsDirty = false;
+    int m_numCoalescedUpdates = 0;
 };
 
 
@@ -24,6 +24,10 @@
 #include <QPixmap>
 #include <QPainter>
 
+#ifdef KDDOCKWIDGETS_QTWIDGETS
+# include <QLabel>
+#endif
+
 using namespace KDDockWidgets;
 
 static Draggable* bestDraggable(Draggable *draggable)
@@ -74,11 +78,6 @@ WindowBeingDragged::WindowBeingDragged(Draggable *draggable)
     : m_draggable(draggable)
     , m_draggableWidget(m_draggable->asWidget())
 {
-    if (!isWayland()) {
-        qWarning() << Q_FUNC_INFO << "Wrong ctor called."; // Doesn't happen
-        Q_ASSERT(false);
-        return;
-    }
 }
 
 #ifdef DOCKS_DEVELOPER_MODE
@@ -99,7 +98,7 @@ WindowBeingDragged::~WindowBeingDragged()
     if (!isWayland()) { // Wayland doesn't support setting opacity
         // Restore opacity to fully opaque if needed
         const qreal opacity = Config::self().draggedWindowOpacity();
-        if (!qIsNaN(opacity) && !qFuzzyCompare(1.0, opacity))
+        if (!qIsNaN(opacity) && !qFuzzyCompare(1.0, opacity) && m_floatingWindow)
             m_floatingWindow->setWindowOpacity(1);
     }
 }
@@ -182,10 +181,21 @@ Draggable *WindowBeingDragged::draggable() const
     return m_draggable;
 }
 
+bool WindowBeingDragged::isInPlaceDrop(Frame *, DropIndicatorOverlayInterface::DropLocation) const
+{
+    // Either the floating window exists already, or, with Wayland, it's always created on drop
+    return false;
+}
+
 WindowBeingDraggedWayland::WindowBeingDraggedWayland(Draggable *draggable)
+    : WindowBeingDraggedWayland(draggable, /*waylandOnly=*/true)
+{
+}
+
+WindowBeingDraggedWayland::WindowBeingDraggedWayland(Draggable *draggable, bool waylandOnly)
     : WindowBeingDragged(draggable)
 {
-    if (!isWayland()) {
+    if (waylandOnly && !isWayland()) {
         // Doesn't happen
         qWarning() << Q_FUNC_INFO << "This CTOR is only called on Wayland";
         Q_ASSERT(false);
@@ -302,3 +312,62 @@ QSize WindowBeingDraggedWayland::maxSize() const
     qWarning() << Q_FUNC_INFO << "Unknown maxSize, shouldn't happen";
     return {};
 }
+
+#ifdef KDDOCKWIDGETS_QTWIDGETS
+
+WindowBeingDraggedProxy::WindowBeingDraggedProxy(Draggable *draggable, QPoint topLeft)
+    : WindowBeingDraggedWayland(draggable, /*waylandOnly=*/false)
+    , m_proxy(new QLabel(nullptr, Qt::Tool | Qt::FramelessWindowHint | Qt::WindowTransparentForInput
+                                  | Qt::WindowDoesNotAcceptFocus))
+{
+    if (m_frame) {
+        m_pixmap = m_frame->grab();
+    } else if (m_dockWidget) {
+        m_pixmap = m_dockWidget->grab();
+    }
+
+    m_proxy->setObjectName(QStringLiteral("_docks_DeferredDetachProxy"));
+    m_proxy->setAttribute(Qt::WA_ShowWithoutActivating);
+    m_proxy->setPixmap(m_pixmap);
+
+    const qreal opacity = Config::self().draggedWindowOpacity();
+    m_proxy->setWindowOpacity(qIsNaN(opacity) ? 0.7 : opacity);
+    m_proxy->setGeometry(QRect(topLeft, size()));
+    m_proxy->show();
+
+    // The draggable stays visible, so it can keep the grab for the whole drag
+    grabMouse(true);
+}
+
+WindowBeingDraggedProxy::~WindowBeingDraggedProxy()
+{
+}
+
+QPixmap WindowBeingDraggedProxy::pixmap() const
+{
+    return m_pixmap;
+}
+
+QWindow *WindowBeingDraggedProxy::proxyWindow() const
+{
+    return m_proxy->windowHandle();
+}
+
+bool WindowBeingDraggedProxy::isInPlaceDrop(Frame *acceptingFrame, DropIndicatorOverlayInterface::DropLocation location) const
+{
+    // The frame is still hovered while over an outer indicator, but that moves it to the layout's edge
+    if (!acceptingFrame || DropIndicatorOverlayInterface::isOutterLocation(location))
+        return false;
+
+    if (m_frame) {
+        // Any inner location relative to itself puts it back where it was
+        return acceptingFrame == m_frame && location != DropIndicatorOverlayInterface::DropLocation_None;
+    } else if (m_dockWidget) {
+        // Only tabbing into its own frame, it can still be put side-by-side with its old tabs
+        return location == DropIndicatorOverlayInterface::DropLocation_Center && acceptingFrame == m_dockWidget->frame();
+    }
+
+    return false;
+}
+
+#endif
@@ -14,11 +14,16 @@
 
 #include "docks_export.h"
 #include "FloatingWindow_p.h"
+#include "DropIndicatorOverlayInterface_p.h"
 
 #include <QPointer>
+#include <QPixmap>
+
+#include <memory>
 
 QT_BEGIN_NAMESPACE
-class QPixmap;
+class QLabel;
+class QWindow;
 QT_END_NAMESPACE
 
 namespace KDDockWidgets {
@@ -69,6 +74,15 @@ public:
 
     /// @brief Returns the draggable
     Draggable *draggable() const;
+
+    /// @brief Returns the window following the mouse instead of the floating window, which doesn't exist yet.
+    /// Only with Config::Flag_DeferredDetach, nullptr otherwise.
+    virtual QWindow *proxyWindow() const { return nullptr; }
+
+    /// @brief Returns whether dropping onto @p acceptingFrame would put the contents back where they already are.
+    /// Only possible if nothing was detached yet, see WindowBeingDraggedProxy.
+    /// @param location the drop indicator being dropped on. Outer indicators always change the layout.
+    virtual bool isInPlaceDrop(Frame *acceptingFrame, DropIndicatorOverlayInterface::DropLocation location) const;
 protected:
     explicit WindowBeingDragged(Draggable *);
     Q_DISABLE_COPY(WindowBeingDragged)
@@ -93,10 +107,39 @@ public:
     // These two are set for Wayland only, where we can't make the floating window immediately (no way to position it)
     // So we're dragging either a frame with multiple dock widgets or a single tab, keep them here.
     // It's important to know what we're dragging, so drop rubber band respect min/max sizes.
+    // Also used by WindowBeingDraggedProxy, which delays the floating window on purpose.
     QPointer<Frame> m_frame;
     QPointer<DockWidgetBase> m_dockWidget;
+
+protected:
+    ///@brief For WindowBeingDraggedProxy, which isn't Wayland specific
+    WindowBeingDraggedWayland(Draggable *draggable, bool waylandOnly);
 };
 
+#ifdef KDDOCKWIDGETS_QTWIDGETS
+/**
+ * @brief Used with Config::Flag_DeferredDetach.
+ *
+ * Like with Wayland, the frame or tab being dragged stays in its layout and the floating window is only
+ * created on drop. Instead of QDrag, a translucent window showing a snapshot of it follows the mouse.
+ */
+struct WindowBeingDraggedProxy : public WindowBeingDraggedWayland
+{
+public:
+    ///@param topLeft the initial global position of the proxy window
+    explicit WindowBeingDraggedProxy(Draggable *draggable, QPoint topLeft);
+    ~WindowBeingDraggedProxy() override;
+
+    QPixmap pixmap() const override;
+    QWindow *proxyWindow() const override;
+    bool isInPlaceDrop(Frame *acceptingFrame, DropIndicatorOverlayInterface::DropLocation location) const override;
+
+private:
+    QPixmap m_pixmap; // Grabbed once, when the drag starts
+    std::unique_ptr<QLabel> m_proxy;
+};
+#endif
+
 }
 
 #endif
@@ -20,8 +20,41 @@
 #include "ClassicIndicatorsWindow_p.h"
 #include "Utils_p.h"
 
+#include <QPointer>
+
 using namespace KDDockWidgets;
 
+namespace {
+
+// A single indicator window and rubber band are shared by all ClassicIndicators, as only one
+// DropArea is hovered at a time. So the native window and the indicator images are created once,
+// instead of on the first hover of each DropArea, which for floating windows is on every drag.
+struct SharedIndicators
+{
+    int refCount = 0;
+    IndicatorWindow *window = nullptr;
+    QPointer<QWidgetOrQuick> rubberBand; // Parented to the last hovered DropArea, which might be deleted
+    ClassicIndicators *owner = nullptr;
+};
+
+SharedIndicators &sharedIndicators()
+{
+    static SharedIndicators s_shared;
+    return s_shared;
+}
+
+bool usesSharedIndicators()
+{
+#ifdef KDDOCKWIDGETS_QTWIDGETS
+    // On Wayland the indicator window is a child of the overlay, as we can't position top-levels
+    return !isWayland();
+#else
+    return false;
+#endif
+}
+
+}
+
 static IndicatorWindow* createIndicatorWindow(ClassicIndicators *classicIndicators)
 {
     auto window = new IndicatorWindow(classicIndicators);
@@ -31,24 +64,84 @@ static IndicatorWindow* createIndicatorWindow(ClassicIndicators *classicIndicato
 
 ClassicIndicators::ClassicIndicators(DropArea *dropArea)
     : DropIndicatorOverlayInterface(dropArea) // Is parented on the drop-area, not a toplevel.
-    , m_rubberBand(Config::self().frameworkWidgetFactory()->createRubberBand(dropArea))
-    , m_indicatorWindow(createIndicatorWindow(this))
+    , m_usesSharedIndicators(usesSharedIndicators())
 {
+    if (m_usesSharedIndicators) {
+        SharedIndicators &shared = sharedIndicators();
+        if (shared.refCount++ == 0) {
+            shared.window = createIndicatorWindow(nullptr);
+            // Pay for the native window now, instead of on the first hover
+            shared.window->create();
+        }
+    } else {
+        m_rubberBand = Config::self().frameworkWidgetFactory()->createRubberBand(dropArea);
+        m_indicatorWindow = createIndicatorWindow(this);
+    }
 }
 
 ClassicIndicators::~ClassicIndicators()
 {
-    delete m_indicatorWindow;
+    if (m_usesSharedIndicators) {
+        releaseSharedIndicators();
+        SharedIndicators &shared = sharedIndicators();
+        if (--shared.refCount == 0) {
+            delete shared.window;
+            shared.window = nullptr;
+        }
+    } else {
+        delete m_indicatorWindow;
+    }
+}
+
+void ClassicIndicators::acquireSharedIndicators()
+{
+    if (!m_usesSharedIndicators || m_indicatorWindow)
+        return;
+
+    SharedIndicators &shared = sharedIndicators();
+    if (shared.owner)
+        shared.owner->releaseSharedIndicators();
+
+    if (!shared.rubberBand) {
+        shared.rubberBand = Config::self().frameworkWidgetFactory()->createRubberBand(m_dropArea);
+    } else if (shared.rubberBand->parentWidget() != m_dropArea) {
+        shared.rubberBand->setParent(m_dropArea);
+    }
+
+    shared.owner = this;
+    shared.window->setClassicIndicators(this);
+    m_indicatorWindow = shared.window;
+    m_rubberBand = shared.rubberBand;
+}
+
+void ClassicIndicators::releaseSharedIndicators()
+{
+    SharedIndicators &shared = sharedIndicators();
+    if (!m_usesSharedIndicators || shared.owner != this)
+        return;
+
+    if (m_rubberBand && shared.rubberBand)
+        m_rubberBand->setVisible(false);
+    m_indicatorWindow->setVisible(false);
+    updateIndicatorsVisibility(false);
+    m_indicatorWindow->setClassicIndicators(nullptr);
+
+    shared.owner = nullptr;
+    m_indicatorWindow = nullptr;
+    m_rubberBand = nullptr;
 }
 
 DropIndicatorOverlayInterface::DropLocation ClassicIndicators::hover_impl(QPoint globalPos)
 {
+    if (!m_indicatorWindow)
+        return DropLocation_None;
+
     return m_indicatorWindow->hover(globalPos);
 }
 
 QPoint ClassicIndicators::posForIndicator(DropIndicatorOverlayInterface::DropLocation loc) const
 {
-    return m_indicatorWindow->posForIndicator(loc);
+    return m_indicatorWindow ? m_indicatorWindow->posForIndicator(loc) : QPoint();
 }
 
 bool ClassicIndicators::innerIndicatorsVisible() const
@@ -68,18 +161,22 @@ bool ClassicIndicators::tabIndicatorVisible() const
 
 bool ClassicIndicators::onResize(QSize)
 {
-     m_indicatorWindow->resize(window()->size());
-     return false;
+    if (m_indicatorWindow)
+        m_indicatorWindow->resize(window()->size());
+    return false;
 }
 
 void ClassicIndicators::updateVisibility()
 {
     if (isHovered()) {
+        acquireSharedIndicators();
         m_indicatorWindow->updatePositions();
         m_indicatorWindow->setVisible(true);
         updateWindowPosition();
         updateIndicatorsVisibility(true);
         raiseIndicators();
+    } else if (m_usesSharedIndicators) {
+        releaseSharedIndicators();
     } else {
         m_rubberBand->setVisible(false);
         m_indicatorWindow->setVisible(false);
@@ -117,7 +214,8 @@ void ClassicIndicators::updateIndicatorsVisibility(bool visible)
 
 void ClassicIndicators::raiseIndicators()
 {
-    m_indicatorWindow->raise();
+    if (m_indicatorWindow)
+        m_indicatorWindow->raise();
 }
 
 KDDockWidgets::Location locationToMultisplitterLocation(ClassicIndicators::DropLocation location)
@@ -148,6 +246,9 @@ void ClassicIndicators::setDropLocation(ClassicIndicators::DropLocation location
 {
     setCurrentDropLocation(location);
 
+    if (!m_rubberBand) // Not hovered anymore
+        return;
+
     if (location == DropLocation_None) {
         m_rubberBand->setVisible(false);
         return;
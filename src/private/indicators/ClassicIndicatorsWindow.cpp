@@ -117,27 +117,45 @@ static Qt::WindowFlags flagsForIndicatorWindow()
 
 IndicatorWindow::IndicatorWindow(ClassicIndicators *classicIndicators_)
     : QWidget(parentForIndicatorWindow(classicIndicators_), flagsForIndicatorWindow())
-    , classicIndicators(classicIndicators_)
-    , m_center(new Indicator(classicIndicators, this, DropIndicatorOverlayInterface::DropLocation_Center)) // Each indicator is not a top-level. Otherwise there's noticeable delay.
-    , m_left(new Indicator(classicIndicators, this, DropIndicatorOverlayInterface::DropLocation_Left))
-    , m_right(new Indicator(classicIndicators, this, DropIndicatorOverlayInterface::DropLocation_Right))
-    , m_bottom(new Indicator(classicIndicators, this, DropIndicatorOverlayInterface::DropLocation_Bottom))
-    , m_top(new Indicator(classicIndicators, this, DropIndicatorOverlayInterface::DropLocation_Top))
-    , m_outterLeft(new Indicator(classicIndicators, this, DropIndicatorOverlayInterface::DropLocation_OutterLeft))
-    , m_outterRight(new Indicator(classicIndicators, this, DropIndicatorOverlayInterface::DropLocation_OutterRight))
-    , m_outterBottom(new Indicator(classicIndicators, this, DropIndicatorOverlayInterface::DropLocation_OutterBottom))
-    , m_outterTop(new Indicator(classicIndicators, this, DropIndicatorOverlayInterface::DropLocation_OutterTop))
+    , m_center(new Indicator(classicIndicators_, this, DropIndicatorOverlayInterface::DropLocation_Center)) // Each indicator is not a top-level. Otherwise there's noticeable delay.
+    , m_left(new Indicator(classicIndicators_, this, DropIndicatorOverlayInterface::DropLocation_Left))
+    , m_right(new Indicator(classicIndicators_, this, DropIndicatorOverlayInterface::DropLocation_Right))
+    , m_bottom(new Indicator(classicIndicators_, this, DropIndicatorOverlayInterface::DropLocation_Bottom))
+    , m_top(new Indicator(classicIndicators_, this, DropIndicatorOverlayInterface::DropLocation_Top))
+    , m_outterLeft(new Indicator(classicIndicators_, this, DropIndicatorOverlayInterface::DropLocation_OutterLeft))
+    , m_outterRight(new Indicator(classicIndicators_, this, DropIndicatorOverlayInterface::DropLocation_OutterRight))
+    , m_outterBottom(new Indicator(classicIndicators_, this, DropIndicatorOverlayInterface::DropLocation_OutterBottom))
+    , m_outterTop(new Indicator(classicIndicators_, this, DropIndicatorOverlayInterface::DropLocation_OutterTop))
 {
     setWindowFlag(Qt::FramelessWindowHint, true);
     setAttribute(Qt::WA_TranslucentBackground);
 
-    connect(classicIndicators, &ClassicIndicators::innerIndicatorsVisibleChanged,
-            this, &IndicatorWindow::updateIndicatorVisibility);
-    connect(classicIndicators, &ClassicIndicators::outterIndicatorsVisibleChanged,
-            this, &IndicatorWindow::updateIndicatorVisibility);
-
     m_indicators << m_center << m_left << m_right << m_top << m_bottom
                  << m_outterBottom << m_outterTop << m_outterLeft << m_outterRight;
+
+    setClassicIndicators(classicIndicators_);
+}
+
+void IndicatorWindow::setClassicIndicators(ClassicIndicators *classicIndicators_)
+{
+    if (classicIndicators_ == classicIndicators)
+        return;
+
+    if (classicIndicators)
+        disconnect(classicIndicators, nullptr, this, nullptr);
+
+    classicIndicators = classicIndicators_;
+    for (Indicator *indicator : qAsConst(m_indicators)) {
+        indicator->q = classicIndicators;
+        indicator->m_hovered = false;
+    }
+
+    if (classicIndicators) {
+        connect(classicIndicators, &ClassicIndicators::innerIndicatorsVisibleChanged,
+                this, &IndicatorWindow::updateIndicatorVisibility);
+        connect(classicIndicators, &ClassicIndicators::outterIndicatorsVisibleChanged,
+                this, &IndicatorWindow::updateIndicatorVisibility);
+    }
 }
 
 Indicator *IndicatorWindow::indicatorForLocation(DropIndicatorOverlayInterface::DropLocation loc) const
@@ -233,7 +251,7 @@ void IndicatorWindow::updatePositions()
     m_outterBottom->move(r.center().x() - halfIndicatorWidth, r.y() + height() - indicatorWidth - OUTTER_INDICATOR_MARGIN);
     m_outterTop->move(r.center().x() - halfIndicatorWidth, r.y() + OUTTER_INDICATOR_MARGIN);
     m_outterRight->move(r.x() + width() - indicatorWidth - OUTTER_INDICATOR_MARGIN, r.center().y() - halfIndicatorWidth);
-    Frame *hoveredFrame = classicIndicators->m_hoveredFrame;
+    Frame *hoveredFrame = classicIndicators ? classicIndicators->m_hoveredFrame : nullptr;
     if (hoveredFrame) {
         QRect hoveredRect = hoveredFrame->QWidget::geometry();
         m_center->move(r.topLeft() + hoveredRect.center() - QPoint(halfIndicatorWidth, halfIndicatorWidth));
@@ -31,6 +31,9 @@ class IndicatorWindow : public QWidget
 public:
     explicit IndicatorWindow(ClassicIndicators *classicIndicators);
     DropIndicatorOverlayInterface::DropLocation hover(QPoint globalPos);
+
+    ///@brief Changes which ClassicIndicators this window is showing, as it's shared by all of them
+    void setClassicIndicators(ClassicIndicators *);
     void updatePositions();
     QPoint posForIndicator(DropIndicatorOverlayInterface::DropLocation) const;
 private:
@@ -43,7 +46,7 @@ private:
 
     Indicator *indicatorForLocation(DropIndicatorOverlayInterface::DropLocation loc) const;
 
-    ClassicIndicators *const classicIndicators;
+    ClassicIndicators *classicIndicators = nullptr;
     Indicator *const m_center;
     Indicator *const m_left;
     Indicator *const m_right;
@@ -71,7 +74,7 @@ public:
 
     QImage m_image;
     QImage m_imageActive;
-    ClassicIndicators *const q;
+    ClassicIndicators *q;
     bool m_hovered = false;
     const DropIndicatorOverlayInterface::DropLocation m_dropLocation;
 };
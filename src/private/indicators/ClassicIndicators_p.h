@@ -52,8 +52,13 @@ private:
     void setDropLocation(DropLocation);
     void updateWindowPosition();
 
-    QWidgetOrQuick *const m_rubberBand;
-    IndicatorWindow *const m_indicatorWindow;
+    ///@brief takes the indicator window and rubber band shared by all ClassicIndicators, while hovered
+    void acquireSharedIndicators();
+    void releaseSharedIndicators();
+
+    const bool m_usesSharedIndicators;
+    QWidgetOrQuick *m_rubberBand = nullptr; // Only set while hovered, if shared
+    IndicatorWindow *m_indicatorWindow = nullptr; // Only set while hovered, if shared
     bool m_innerIndicatorsVisible = false;
     bool m_outterIndicatorsVisible = false;
     bool m_tabIndicatorVisible = false;
@@ -15,6 +15,10 @@
 
 #include <QPainter>
 #include <QPainterPath>
+#include <QPaintEvent>
+
+#include <algorithm>
+#include <iterator>
 
 #define SEGMENT_GIRTH 50
 #define SEGMENT_PEN_WIDTH 4
@@ -42,27 +46,64 @@ DropIndicatorOverlayInterface::DropLocation SegmentedIndicators::hover_impl(QPoi
 {
     m_hoveredPt = mapFromGlobal(pt);
     updateSegments();
+
+    const DropLocation oldLocation = currentDropLocation();
     setCurrentDropLocation(dropLocationForPos(m_hoveredPt));
+    if (oldLocation != currentDropLocation()) {
+        // Only the segments which changed color need repainting
+        updateSegment(oldLocation);
+        updateSegment(currentDropLocation());
+    }
 
     return currentDropLocation();
 }
 
+///@brief Returns which of the 4 segments along the edges of @p r contains @p pos, as an offset
+///to DropLocation_Left, or -1. Each segment is a trapezoid SEGMENT_GIRTH deep, so a point belongs
+///to the segment of the nearest edge.
+static int edgeSegmentForPos(QRect r, QPoint pos)
+{
+    if (!r.isValid() || !r.contains(pos))
+        return -1;
+
+    const int distances[] = { pos.x() - r.left(), pos.y() - r.top(),
+                              r.right() - pos.x(), r.bottom() - pos.y() };
+
+    const int *nearest = std::min_element(std::begin(distances), std::end(distances));
+    if (*nearest > SEGMENT_GIRTH)
+        return -1;
+
+    return int(nearest - std::begin(distances));
+}
+
 DropIndicatorOverlayInterface::DropLocation SegmentedIndicators::dropLocationForPos(QPoint pos) const
 {
-    for (auto it = m_segments.cbegin(), end = m_segments.cend(); it != end; ++it) {
-        if (it.value().containsPoint(pos, Qt::OddEvenFill)) {
-            return it.key();
+    if (m_innerRect.isValid()) {
+        // The center is shaped like a folder, its top right corner is not part of it
+        if (m_centerRect.isValid() && m_centerRect.contains(pos)) {
+            const bool inTabCorner = pos.x() > m_centerRect.left() + m_centerTabSize.width()
+                && pos.y() < m_centerRect.top() + m_centerTabSize.height();
+            if (!inTabCorner)
+                return DropLocation_Center;
         }
+
+        const int segment = edgeSegmentForPos(m_innerRect, pos);
+        if (segment != -1)
+            return DropLocation(DropLocation_Left + segment);
     }
 
+    const int segment = edgeSegmentForPos(m_outterRect, pos);
+    if (segment != -1)
+        return DropLocation(DropLocation_OutterLeft + segment);
+
     return DropLocation_None;
 }
 
-void SegmentedIndicators::paintEvent(QPaintEvent *)
+void SegmentedIndicators::paintEvent(QPaintEvent *ev)
 {
     QPainter p(this);
     p.setRenderHint(QPainter::Antialiasing, true);
-    drawSegments(&p);
+    drawSegments(&p, ev->rect());
 }
 
 QVector<QPolygon> SegmentedIndicators::segmentsForRect(QRect r, QPolygon &center, bool useOffset) const
@@ -135,9 +176,23 @@ QVector<QPolygon> SegmentedIndicators::segmentsForRect(QRect r, QPolygon &center
 
 void SegmentedIndicators::updateSegments()
 {
+    const bool hasMultipleFrames = m_dropArea->count() > 1;
+    if (m_segmentsValid && m_segmentsSize == size() && m_segmentsFrameRect == hoveredFrameRect()
+        && m_segmentsHaveMultipleFrames == hasMultipleFrames) {
+        // Nothing changed since the last hover
+        return;
+    }
+
+    m_segmentsValid = true;
+    m_segmentsSize = size();
+    m_segmentsFrameRect = hoveredFrameRect();
+    m_segmentsHaveMultipleFrames = hasMultipleFrames;
+
     m_segments.clear();
+    m_innerRect = {};
+    m_outterRect = {};
+    m_centerRect = {};
 
-    const bool hasMultipleFrames = m_dropArea->count() > 1;
     const bool needsInnerIndicators = hoveredFrameRect().isValid();
     const bool needsOutterIndicators = hasMultipleFrames || !needsInnerIndicators;
     QPolygon center;
@@ -149,24 +204,43 @@ void SegmentedIndicators::updateSegments()
             m_segments.insert(DropLocation(DropLocation_Left + i), segments[i]);
 
         m_segments.insert(DropLocation_Center, center);
+
+        m_innerRect = segments[1].boundingRect().united(segments[3].boundingRect());
+        m_centerRect = center.boundingRect();
+        m_centerTabSize = QSize(center.at(1).x() - center.at(0).x(), center.at(2).y() - center.at(1).y());
     }
 
     if (needsOutterIndicators) {
         auto segments = segmentsForRect(rect(), /*unused*/center);
         for (int i = 0; i < 4; ++i)
             m_segments.insert(DropLocation(DropLocation_OutterLeft + i), segments[i]);
+
+        m_outterRect = segments[1].boundingRect().united(segments[3].boundingRect());
     }
 
     update();
 }
 
-void SegmentedIndicators::drawSegments(QPainter *p)
+void SegmentedIndicators::updateSegment(DropLocation location)
+{
+    const QPolygon segment = m_segments.value(location);
+    if (!segment.isEmpty()) {
+        const int margin = SEGMENT_PEN_WIDTH;
+        update(segment.boundingRect().adjusted(-margin, -margin, margin, margin));
+    }
+}
+
+void SegmentedIndicators::drawSegments(QPainter *p, QRect dirtyRect)
 {
-    for (int i = DropLocation_First; i <= DropLocation_Last; ++i)
-        drawSegment(p, m_segments.value(DropLocation(i)));
+    const int margin = SEGMENT_PEN_WIDTH;
+    for (int i = DropLocation_First; i <= DropLocation_Last; ++i) {
+        const QPolygon segment = m_segments.value(DropLocation(i));
+        if (segment.boundingRect().adjusted(-margin, -margin, margin, margin).intersects(dirtyRect))
+            drawSegment(p, segment, i == currentDropLocation());
+    }
 }
 
-void SegmentedIndicators::drawSegment(QPainter *p, const QPolygon &segment)
+void SegmentedIndicators::drawSegment(QPainter *p, const QPolygon &segment, bool highlighted)
 {
     if (segment.isEmpty())
         return;
@@ -176,7 +250,7 @@ void SegmentedIndicators::drawSegment(QPainter *p, const QPolygon &segment)
     p->setPen(pen);
     QColor brush(0xbb, 0xd5, 0xee, 200);
 
-    if (segment.containsPoint(m_hoveredPt, Qt::OddEvenFill))
+    if (highlighted)
         brush = QColor(0x3574c5);
 
     p->setBrush(brush);
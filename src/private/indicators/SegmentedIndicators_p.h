@@ -35,10 +35,23 @@ protected:
 private:
     QVector<QPolygon> segmentsForRect(QRect, QPolygon &center, bool useOffset = false) const;
     void updateSegments();
-    void drawSegments(QPainter *p);
-    void drawSegment(QPainter *p, const QPolygon &segment);
+    void drawSegments(QPainter *p, QRect dirtyRect);
+    void drawSegment(QPainter *p, const QPolygon &segment, bool highlighted);
+    void updateSegment(DropLocation);
     QPoint m_hoveredPt = {};
     QHash<DropLocation, QPolygon> m_segments;
+
+    // What m_segments was computed for. They're only recomputed when one of these changes.
+    QSize m_segmentsSize;
+    QRect m_segmentsFrameRect;
+    bool m_segmentsHaveMultipleFrames = false;
+    bool m_segmentsValid = false;
+
+    // The same segments, in the form used for hit testing
+    QRect m_innerRect; // Invalid if there's no inner segments
+    QRect m_outterRect; // Invalid if there's no outter segments
+    QRect m_centerRect;
+    QSize m_centerTabSize;
 };
 
 }
@@ -200,6 +200,15 @@ void Item::setGuestWidget(Widget *guest)
     updateObjectName();
 }
 
+void Item::releaseGuestWidget()
+{
+    if (!m_guest)
+        return;
+
+    setGuestWidget(nullptr); // disconnects from it
+    onWidgetDestroyed();
+}
+
 void Item::updateWidgetGeometries()
 {
     if (m_guest) {
@@ -221,14 +230,15 @@ QVariantMap Item::toVariantMap() const
     return result;
 }
 
-void Item::fillFromVariantMap(const QVariantMap &map, const QHash<QString, Widget *> &widgets)
+void Item::fillFromVariantMap(const QVariantMap &map, const QHash<qint64, Widget *> &widgets)
 {
     m_sizingInfo.fromVariantMap(map[QStringLiteral("sizingInfo")].toMap());
     m_isVisible = map[QStringLiteral("isVisible")].toBool();
     setObjectName(map[QStringLiteral("objectName")].toString());
 
-    const QString guestId = map.value(QStringLiteral("guestId")).toString();
-    if (!guestId.isEmpty()) {
+    // Layouts saved by older versions have the id as a string, toLongLong() handles both
+    const qint64 guestId = map.value(QStringLiteral("guestId")).toLongLong();
+    if (guestId > 0) {
         if (Widget *guest = widgets.value(guestId)) {
             setGuestWidget(guest);
             m_guest->setParent(hostWidget());
@@ -239,7 +249,7 @@ void Item::fillFromVariantMap(const QVariantMap &map, const QHash<QString, Widge
 }
 
 Item *Item::createFromVariantMap(Widget *hostWidget, ItemContainer *parent,
-                                 const QVariantMap &map, const QHash<QString, Widget *> &widgets)
+                                 const QVariantMap &map, const QHash<qint64, Widget *> &widgets)
 {
     auto item = new Item(hostWidget, parent);
     item->fillFromVariantMap(map, widgets);
@@ -255,7 +265,7 @@ void Item::unref()
 {
     Q_ASSERT(m_refCount > 0);
     m_refCount--;
-    if (m_refCount == 0) {
+    if (m_refCount == 0 && !isTearingDown()) {
         Q_ASSERT(!isRoot());
         parentContainer()->removeItem(this);
     }
@@ -599,6 +609,14 @@ bool Item::isPlaceholder() const
     return !isVisible();
 }
 
+qint64 Item::placeholderAge() const
+{
+    if (!isPlaceholder())
+        return -1;
+
+    return m_placeholderTimer.isValid() ? m_placeholderTimer.elapsed() : 0;
+}
+
 bool Item::isVisible(bool excludeBeingInserted) const
 {
     return m_isVisible && !(excludeBeingInserted && isBeingInserted());
@@ -608,6 +626,10 @@ void Item::setIsVisible(bool is)
 {
     if (is != m_isVisible) {
         m_isVisible = is;
+        if (is)
+            m_placeholderTimer.invalidate();
+        else
+            m_placeholderTimer.start();
         Q_EMIT visibleChanged(this, is);
     }
 
@@ -753,6 +775,7 @@ Item::Item(Widget *hostWidget, ItemContainer *parent)
     , m_parent(parent)
     , m_hostWidget(hostWidget)
 {
+    m_placeholderTimer.start();
     connectParent(parent);
 }
 
@@ -762,6 +785,7 @@ Item::Item(bool isContainer, Widget *hostWidget, ItemContainer *parent)
     , m_parent(parent)
     , m_hostWidget(hostWidget)
 {
+    m_placeholderTimer.start();
     connectParent(parent);
 }
 
@@ -771,7 +795,7 @@ Item::~Item()
 
 bool Item::eventFilter(QObject *widget, QEvent *e)
 {
-    if (e->type() != QEvent::ParentChange)
+    if (e->type() != QEvent::ParentChange || isTearingDown())
         return false;
 
     QObject *host = hostWidget() ? hostWidget()->asQObject() : nullptr;
@@ -815,6 +839,11 @@ void Item::onWidgetDestroyed()
 {
     m_guest = nullptr;
 
+    if (isTearingDown()) {
+        // The whole layout is going away, no point in turning into placeholder or relayouting
+        return;
+    }
+
     if (m_refCount) {
         turnIntoPlaceholder();
     } else if (!isRoot()) {
@@ -824,6 +853,9 @@ void Item::onWidgetDestroyed()
 
 void Item::onWidgetLayoutRequested()
 {
+    if (isTearingDown())
+        return;
+
     if (Widget *w = guestWidget()) {
         if (w->size() != size()) {
             qDebug() << Q_FUNC_INFO << "TODO: Not implemented yet. Widget can't just decide to resize yet"
@@ -846,6 +878,12 @@ bool Item::isRoot() const
     return m_parent == nullptr;
 }
 
+bool Item::isTearingDown() const
+{
+    ItemContainer *r = root();
+    return r && r->d->m_isTearingDown;
+}
+
 Item::LayoutBorderLocations Item::adjacentLayoutBorders() const
 {
     if (isRoot()) {
@@ -962,6 +1000,7 @@ struct ItemContainer::Private
     bool m_blockUpdatePercentages = false;
     bool m_isDeserializing = false;
     bool m_isSimplifying = false;
+    bool m_isTearingDown = false;
     Qt::Orientation m_orientation = Qt::Vertical;
     Item::List m_children;
     ItemContainer *const q;
@@ -1629,6 +1668,12 @@ void ItemContainer::clear()
     d->deleteSeparators();
 }
 
+void ItemContainer::setIsTearingDown(bool is)
+{
+    Q_ASSERT(isRoot());
+    d->m_isTearingDown = is;
+}
+
 Item* ItemContainer::itemForObject(const QObject *o) const
 {
     for (Item *item : qAsConst(d->m_children)) {
@@ -3338,7 +3383,7 @@ QVariantMap ItemContainer::toVariantMap() const
 }
 
 void ItemContainer::fillFromVariantMap(const QVariantMap &map,
-                                       const QHash<QString, Widget*> &widgets)
+                                       const QHash<qint64, Widget*> &widgets)
 {
     QScopedValueRollback<bool> deserializing(d->m_isDeserializing, true);
 
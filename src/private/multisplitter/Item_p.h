@@ -17,6 +17,7 @@
 #include <QVector>
 #include <QRect>
 #include <QVariant>
+#include <QElapsedTimer>
 #include <QDebug>
 
 #include <memory>
@@ -262,6 +263,10 @@ public:
 
     bool isRoot() const;
 
+    ///@brief Returns whether the layout this item belongs to is being destroyed.
+    ///See ItemContainer::setIsTearingDown()
+    bool isTearingDown() const;
+
     ///@brief Returns whether the item is touching the layout's borders.
     ///Returns Location_None if it's not touching a border.
     LayoutBorderLocations adjacentLayoutBorders() const;
@@ -293,6 +298,10 @@ public:
     void setMinSize(QSize);
     void setMaxSizeHint(QSize);
     bool isPlaceholder() const;
+
+    ///@brief returns for how many milliseconds this item has been a placeholder, or -1 if it's visible
+    qint64 placeholderAge() const;
+
     void setGeometry(QRect rect);
     ItemContainer *root() const;
     QRect mapToRoot(QRect) const;
@@ -307,6 +316,9 @@ public:
     Widget *guestWidget() const { return m_guest; }
     void setGuestWidget(Widget *);
 
+    ///@brief Forgets the guest, as if it had been destroyed. Used when the guest is going to be reused.
+    void releaseGuestWidget();
+
     void ref();
     void unref();
     int refCount() const;
@@ -328,10 +340,10 @@ public:
     virtual void dumpLayout(int level = 0);
     virtual void setHostWidget(Widget *);
     virtual QVariantMap toVariantMap() const;
-    virtual void fillFromVariantMap(const QVariantMap &map, const QHash<QString, Widget*> &widgets);
+    virtual void fillFromVariantMap(const QVariantMap &map, const QHash<qint64, Widget*> &widgets);
 
     static Item* createFromVariantMap(Widget *hostWidget, ItemContainer *parent,
-                                      const QVariantMap &map, const QHash<QString, Widget *> &widgets);
+                                      const QVariantMap &map, const QHash<qint64, Widget *> &widgets);
 
 Q_SIGNALS:
     void geometryChanged();
@@ -377,6 +389,7 @@ private:
     void updateObjectName();
     void onWidgetDestroyed();
     bool m_isVisible = false;
+    QElapsedTimer m_placeholderTimer;
     Widget *m_hostWidget = nullptr;
     Widget *m_guest = nullptr;
 };
@@ -415,8 +428,17 @@ public:
     void setSize_recursive(QSize newSize, ChildrenResizeStrategy strategy = ChildrenResizeStrategy::Percentage) override;
     QRect suggestedDropRect(const Item *item, const Item *relativeTo, Location) const;
     QVariantMap toVariantMap() const override;
-    void fillFromVariantMap(const QVariantMap &map, const QHash<QString, Widget *> &widgets) override;
+    void fillFromVariantMap(const QVariantMap &map, const QHash<qint64, Widget *> &widgets) override;
     void clear();
+
+    /**
+     * @brief Marks the whole layout as being destroyed. Only valid on the root container.
+     *
+     * While set, guests being destroyed and items losing their last reference don't trigger any
+     * relayout, as the items are all going to be deleted together with the root anyway.
+     */
+    void setIsTearingDown(bool);
+
     Qt::Orientation orientation() const;
     bool isVertical() const;
     bool isHorizontal() const;
@@ -520,8 +542,10 @@ Q_SIGNALS:
 public:
     QVector<Layouting::Separator*> separators_recursive() const;
     QVector<Layouting::Separator*> separators() const;
-private:
+
+    ///@brief Removes unneeded nesting, for example after placeholders were removed
     void simplify();
+private:
     static bool s_inhibitSimplify;
     friend class Layouting::Item;
     friend class ::TestMultiSplitter;
@@ -17,7 +17,7 @@ using namespace Layouting;
 static qint64 s_nextFrameId = 1;
 
 Widget::Widget(QObject *thisObj)
-    : m_id(QString::number(s_nextFrameId++))
+    : m_id(s_nextFrameId++)
     , m_thisObj(thisObj)
 {
 }
@@ -26,7 +26,7 @@ Widget::~Widget()
 {
 }
 
-QString Widget::id() const
+qint64 Widget::id() const
 {
     return m_id;
 }
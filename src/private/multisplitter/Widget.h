@@ -128,7 +128,8 @@ public:
     }
 
     ///@brief returns an id for corelation purposes for saving layouts
-    QString id() const;
+    ///Ids start at 1, so 0 can be used as "no id"
+    qint64 id() const;
 
     template <typename T>
     static QSize widgetMinSize(const T *w)
@@ -167,7 +168,7 @@ protected:
     static QSize boundedMaxSize(QSize min, QSize max);
 
 private:
-    const QString m_id;
+    const qint64 m_id;
     QObject *const m_thisObj;
     Q_DISABLE_COPY(Widget)
 };
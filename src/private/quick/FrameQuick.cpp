@@ -33,7 +33,7 @@ FrameQuick::FrameQuick(QWidgetAdapter *parent, FrameOptions options)
     connect(m_dockWidgetModel, &DockWidgetModel::countChanged,
             this, &FrameQuick::updateConstriants);
 
-    connect(this, &QWidgetAdapter::geometryUpdated, this, &Frame::layoutInvalidated);
+    connect(this, &QWidgetAdapter::geometryUpdated, this, &Frame::scheduleSizeConstraintsUpdate);
 
     QQmlComponent component(Config::self().qmlEngine(),
                             QUrl(QStringLiteral("qrc:/kddockwidgets/private/quick/qml/Frame.qml")));
@@ -72,7 +72,7 @@ void FrameQuick::updateConstriants()
     setProperty("kddockwidgets_min_size", minimumSize());
     setProperty("kddockwidgets_max_size", maximumSize());
 
-    Q_EMIT layoutInvalidated();
+    scheduleSizeConstraintsUpdate();
 }
 
 DockWidgetModel *FrameQuick::dockWidgetModel() const
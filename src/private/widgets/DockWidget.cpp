@@ -61,6 +61,8 @@ bool DockWidget::event(QEvent *e)
         onShown(e->spontaneous());
     } else if (e->type() == QEvent::Hide) {
         onHidden(e->spontaneous());
+    } else if (e->type() == QEvent::LayoutRequest) {
+        onLayoutRequest();
     }
 
     return QWidget::event(e);
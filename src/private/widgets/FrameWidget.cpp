@@ -29,7 +29,8 @@
 
 using namespace KDDockWidgets;
 
-///@brieg a QVBoxLayout that emits layoutInvalidated so that Item can detect minSize changes
+///@brieg a QVBoxLayout that emits layoutInvalidated so that Item can detect minSize changes.
+/// Emitted delayed, as there can be many invalidations per event loop iteration
 class VBoxLayout : public QVBoxLayout
 {
 public:
@@ -41,7 +42,7 @@ public:
     void invalidate() override
     {
         QVBoxLayout::invalidate();
-        Q_EMIT m_frameWidget->layoutInvalidated();
+        m_frameWidget->scheduleSizeConstraintsUpdate();
     }
 
     FrameWidget *const m_frameWidget;
@@ -59,6 +59,9 @@ public:
 
 using namespace KDDockWidgets;
 
+// Width of the text area of tabs with Flag_UniformTabWidths, in average characters
+static const int s_uniformTabTextLength = 16;
+
 static MyProxy *proxyStyle()
 {
     static auto *proxy = new MyProxy;
@@ -69,9 +72,55 @@ TabBarWidget::TabBarWidget(TabWidget *parent)
     : QTabBar(parent->asWidget())
     , TabBar(this, parent)
     , m_tabWidget(parent)
+    , m_hasUniformTabWidths(Config::self().flags() & Config::Flag_UniformTabWidths)
 {
     setMovable(Config::self().flags() & Config::Flag_AllowReorderTabs);
     setStyle(proxyStyle());
+
+    if (m_hasUniformTabWidths) {
+        // Tabs which don't fit are scrolled to, instead of squeezing every title
+        setUsesScrollButtons(true);
+        setElideMode(Qt::ElideRight);
+        setExpanding(false);
+    }
+}
+
+bool TabBarWidget::hasUniformTabWidths() const
+{
+    return m_hasUniformTabWidths;
+}
+
+QSize TabBarWidget::tabSizeHint(int index) const
+{
+    return m_hasUniformTabWidths ? uniformTabSize(index)
+                       : QTabBar::tabSizeHint(index);
+}
+
+QSize TabBarWidget::minimumTabSizeHint(int index) const
+{
+    return m_hasUniformTabWidths ? uniformTabSize(index)
+                       : QTabBar::minimumTabSizeHint(index);
+}
+
+QSize TabBarWidget::uniformTabSize(int index) const
+{
+    // QTabBar asks for the size of every tab each time one is added or renamed.
+    // Measure a single tab and reuse it, the titles are elided to fit.
+    if (!m_uniformTabSize.isValid()) {
+        const QSize hint = QTabBar::tabSizeHint(index);
+        const int textWidth = fontMetrics().averageCharWidth() * s_uniformTabTextLength;
+        m_uniformTabSize = QSize(hint.height() + textWidth, hint.height());
+    }
+
+    return m_uniformTabSize;
+}
+
+void TabBarWidget::changeEvent(QEvent *ev)
+{
+    if (ev->type() == QEvent::FontChange || ev->type() == QEvent::StyleChange)
+        m_uniformTabSize = QSize();
+
+    QTabBar::changeEvent(ev);
 }
 
 int TabBarWidget::numDockWidgets() const
@@ -43,13 +43,22 @@ public:
 
     DockWidgetBase *currentDockWidget() const;
 
+    ///@brief returns whether Config::Flag_UniformTabWidths is in effect for this tab bar
+    bool hasUniformTabWidths() const;
+
 protected:
     bool dragCanStart(QPoint pressPos, QPoint pos) const override;
+    QSize tabSizeHint(int index) const override;
+    QSize minimumTabSizeHint(int index) const override;
+    void changeEvent(QEvent *) override;
     void mousePressEvent(QMouseEvent *) override;
     void mouseMoveEvent(QMouseEvent *e) override;
     void mouseDoubleClickEvent(QMouseEvent *e) override;
 private:
+    QSize uniformTabSize(int index) const;
     TabWidget *const m_tabWidget;
+    const bool m_hasUniformTabWidths;
+    mutable QSize m_uniformTabSize;
 };
 }
 
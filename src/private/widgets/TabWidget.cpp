@@ -93,6 +93,15 @@ std::unique_ptr<WindowBeingDragged> TabBar::makeWindow()
     return std::unique_ptr<WindowBeingDragged>(new WindowBeingDragged(floatingWindow, draggable));
 }
 
+bool TabBar::makeWindowDetaches() const
+{
+    // Only detaching a tab out of several is deferred. With a single tab, makeWindow() either
+    // drags the whole frame or nothing.
+    // With re-orderable tabs QTabBar would be left in the middle of a tab move, as the tab stays.
+    return m_lastPressedDockWidget && !hasSingleDockWidget()
+        && !(Config::self().flags() & Config::Flag_AllowReorderTabs);
+}
+
 void TabBar::onMousePress(QPoint localPos)
 {
     m_lastPressedDockWidget = dockWidgetAt(localPos);
@@ -178,7 +187,7 @@ void TabWidget::insertDockWidget(DockWidgetBase *dock, int index)
         // Ideally we would just remove the deleteLater from frame.cpp, but QTabWidget::insertTab()
         // would crash, as it accesses the old tab-widget we're stealing from
 
-        delete oldFrame;
+        oldFrame->recycleOrDelete();
     }
 }
 
@@ -240,6 +249,11 @@ void TabWidget::onTabRemoved()
     m_frame->onDockWidgetCountChanged();
 }
 
+void TabWidget::onTabMoved()
+{
+    m_frame->invalidateDockWidgetsCache();
+}
+
 void TabWidget::onCurrentTabChanged(int index)
 {
     Q_UNUSED(index);
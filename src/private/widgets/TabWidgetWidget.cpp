@@ -21,7 +21,13 @@
 #include "Config.h"
 #include "FrameworkWidgetFactory.h"
 
+#include <QHBoxLayout>
+#include <QLineEdit>
+#include <QMenu>
 #include <QMouseEvent>
+#include <QPointer>
+#include <QToolButton>
+#include <QWidgetAction>
 
 using namespace KDDockWidgets;
 
@@ -31,24 +37,124 @@ TabWidgetWidget::TabWidgetWidget(Frame *parent)
     , m_tabBar(Config::self().frameworkWidgetFactory()->createTabBar(this))
 {
     setTabBar(static_cast<QTabBar*>(m_tabBar->asWidget()));
-    setTabsClosable(Config::self().flags() & Config::Flag_TabsHaveCloseButton);
+
+    if (Config::self().flags() & Config::Flag_UniformTabWidths) {
+        setupCornerButtons();
+    } else {
+        setTabsClosable(Config::self().flags() & Config::Flag_TabsHaveCloseButton);
+    }
 
     // In case tabs closable is set by the factory, a tabClosedRequested() is emitted when the user presses [x]
-    connect(this, &QTabWidget::tabCloseRequested, this, [this] (int index) {
-        if (DockWidgetBase *dw = dockwidgetAt(index)) {
-            if (dw->options() & DockWidgetBase::Option_NotClosable) {
-                qWarning() << "QTabWidget::tabCloseRequested: Refusing to close dock widget with Option_NotClosable option. name=" << dw->uniqueName();
-            } else {
-                dw->close();
-            }
-        } else {
-            qWarning() << "QTabWidget::tabCloseRequested Couldn't find dock widget for index" << index << "; count=" << count();
-        }
-    });
+    connect(this, &QTabWidget::tabCloseRequested, this, &TabWidgetWidget::closeTab);
 
     connect(this, &QTabWidget::currentChanged, this, [this] (int index) {
         onCurrentTabChanged(index);
     });
+
+    connect(QTabWidget::tabBar(), &QTabBar::tabMoved, this, [this] {
+        onTabMoved();
+    });
+}
+
+void TabWidgetWidget::setupCornerButtons()
+{
+    // Instead of a close button per tab, which QTabBar creates for every tab, there's a single one
+    // for the current tab. Tabs that are scrolled out of view can be reached through the overflow menu.
+    m_cornerWidget = new QWidget(this);
+    auto layout = new QHBoxLayout(m_cornerWidget);
+    layout->setContentsMargins(0, 0, 0, 0);
+    layout->setSpacing(0);
+
+    m_overflowMenu = new QMenu(this);
+    m_overflowFilter = new QLineEdit(m_overflowMenu);
+    m_overflowFilter->setPlaceholderText(tr("Search"));
+    m_overflowFilter->setClearButtonEnabled(true);
+    auto filterAction = new QWidgetAction(m_overflowMenu);
+    filterAction->setDefaultWidget(m_overflowFilter);
+    m_overflowMenu->addAction(filterAction);
+    m_overflowMenu->addSeparator();
+
+    connect(m_overflowMenu, &QMenu::aboutToShow, this, &TabWidgetWidget::populateOverflowMenu);
+    connect(m_overflowFilter, &QLineEdit::textChanged, this, &TabWidgetWidget::filterOverflowMenu);
+
+    m_overflowButton = new QToolButton(m_cornerWidget);
+    m_overflowButton->setAutoRaise(true);
+    m_overflowButton->setArrowType(Qt::DownArrow);
+    m_overflowButton->setPopupMode(QToolButton::InstantPopup);
+    m_overflowButton->setMenu(m_overflowMenu);
+    m_overflowButton->setToolTip(tr("All tabs"));
+    layout->addWidget(m_overflowButton);
+
+    if (Config::self().flags() & Config::Flag_TabsHaveCloseButton) {
+        m_closeButton = new QToolButton(m_cornerWidget);
+        m_closeButton->setAutoRaise(true);
+        m_closeButton->setIcon(style()->standardIcon(QStyle::SP_TitleBarCloseButton));
+        m_closeButton->setToolTip(tr("Close"));
+        layout->addWidget(m_closeButton);
+        connect(m_closeButton, &QToolButton::clicked, this, [this] {
+            closeTab(currentIndex());
+        });
+    }
+
+    setCornerWidget(m_cornerWidget, Qt::TopRightCorner);
+    updateCornerButtons();
+}
+
+void TabWidgetWidget::closeTab(int index)
+{
+    if (DockWidgetBase *dw = dockwidgetAt(index)) {
+        if (dw->options() & DockWidgetBase::Option_NotClosable) {
+            qWarning() << "QTabWidget::tabCloseRequested: Refusing to close dock widget with Option_NotClosable option. name=" << dw->uniqueName();
+        } else {
+            dw->close();
+        }
+    } else {
+        qWarning() << "QTabWidget::tabCloseRequested Couldn't find dock widget for index" << index << "; count=" << count();
+    }
+}
+
+void TabWidgetWidget::populateOverflowMenu()
+{
+    // Only built when the menu is shown, so adding or renaming tabs doesn't pay for it
+    const QList<QAction *> actions = m_overflowMenu->actions();
+    for (int i = 2, e = actions.size(); i < e; ++i) // Keep the search field and the separator
+        delete actions.at(i);
+
+    const int current = currentIndex();
+    for (int i = 0, e = count(); i < e; ++i) {
+        QPointer<DockWidgetBase> dw = dockwidgetAt(i);
+        QAction *action = m_overflowMenu->addAction(tabIcon(i), dw->title());
+        action->setCheckable(true);
+        action->setChecked(i == current);
+        connect(action, &QAction::triggered, this, [this, dw] {
+            if (dw)
+                TabWidget::setCurrentDockWidget(dw);
+        });
+    }
+
+    m_overflowFilter->clear();
+    m_overflowFilter->setFocus(Qt::PopupFocusReason);
+}
+
+void TabWidgetWidget::filterOverflowMenu(const QString &text)
+{
+    const QList<QAction *> actions = m_overflowMenu->actions();
+    for (int i = 2, e = actions.size(); i < e; ++i) {
+        QAction *action = actions.at(i);
+        action->setVisible(action->text().contains(text, Qt::CaseInsensitive));
+    }
+}
+
+void TabWidgetWidget::updateCornerButtons()
+{
+    // Like the tab bar, only shown when there's tabs
+    if (m_cornerWidget)
+        m_cornerWidget->setVisible(count() > 1 || !tabBarAutoHide());
+}
+
+QMenu *TabWidgetWidget::overflowMenu() const
+{
+    return m_overflowMenu;
 }
 
 TabBar *TabWidgetWidget::tabBar() const
@@ -100,11 +206,13 @@ void TabWidgetWidget::mousePressEvent(QMouseEvent *ev)
 
 void TabWidgetWidget::tabInserted(int)
 {
+    updateCornerButtons();
     onTabInserted();
 }
 
 void TabWidgetWidget::tabRemoved(int)
 {
+    updateCornerButtons();
     onTabRemoved();
 }
 
@@ -132,11 +240,14 @@ void TabWidgetWidget::insertDockWidget(int index, DockWidgetBase *dw,
 void TabWidgetWidget::setTabBarAutoHide(bool b)
 {
     QTabWidget::setTabBarAutoHide(b);
+    updateCornerButtons();
 }
 
 void TabWidgetWidget::renameTab(int index, const QString &text)
 {
-    setTabText(index, text);
+    // QTabBar relayouts even if the text is the same, which is what happens when just the icon changed
+    if (tabText(index) != text)
+        setTabText(index, text);
 }
 
 DockWidgetBase *TabWidgetWidget::dockwidgetAt(int index) const
@@ -23,6 +23,12 @@
 
 #include <QTabWidget>
 
+QT_BEGIN_NAMESPACE
+class QLineEdit;
+class QMenu;
+class QToolButton;
+QT_END_NAMESPACE
+
 namespace KDDockWidgets {
 
 class Frame;
@@ -39,6 +45,10 @@ public:
     int numDockWidgets() const override;
     void removeDockWidget(DockWidgetBase *) override;
     int indexOfDockWidget(DockWidgetBase *) const override;
+
+    ///@brief returns the menu listing every dock widget, with Config::Flag_UniformTabWidths.
+    ///Otherwise returns nullptr.
+    QMenu *overflowMenu() const;
 protected:
     void paintEvent(QPaintEvent *) override;
     void mouseDoubleClickEvent(QMouseEvent *) override;
@@ -55,8 +65,19 @@ protected:
     int currentIndex() const override;
 
 private:
+    void setupCornerButtons();
+    void closeTab(int index);
+    void populateOverflowMenu();
+    void filterOverflowMenu(const QString &text);
+    void updateCornerButtons();
+
     Q_DISABLE_COPY(TabWidgetWidget)
     TabBar *const m_tabBar;
+    QWidget *m_cornerWidget = nullptr;
+    QToolButton *m_overflowButton = nullptr;
+    QToolButton *m_closeButton = nullptr;
+    QMenu *m_overflowMenu = nullptr;
+    QLineEdit *m_overflowFilter = nullptr;
 };
 }
 
@@ -57,6 +57,7 @@ public:
 
     // Draggable
     std::unique_ptr<WindowBeingDragged> makeWindow() override;
+    bool makeWindowDetaches() const override;
 
     void onMousePress(QPoint localPos);
     void onMouseDoubleClick(QPoint localPos);
@@ -165,6 +166,7 @@ public:
 protected:
     void onTabInserted();
     void onTabRemoved();
+    void onTabMoved();
     void onCurrentTabChanged(int index);
     bool onMouseDoubleClick(QPoint localPos);
 
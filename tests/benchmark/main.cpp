@@ -0,0 +1,381 @@
+/*
+  This file is part of KDDockWidgets.
+
+  SPDX-FileCopyrightText: 2019-2020 Klarälvdalens Datakonsult AB, a KDAB Group company <info@kdab.com>
+  Author: Sérgio Martins <sergio.martins@kdab.com>
+
+  SPDX-License-Identifier: GPL-2.0-only OR GPL-3.0-only
+
+  Contact KDAB at <info@kdab.com> for commercial licensing options.
+*/
+
+/**
+ * @file
+ * @brief Benchmarks LayoutSaver against generated layouts of configurable size.
+ *
+ * Generates a layout with the requested number of main windows, floating windows, dock widgets,
+ * tabs and closed dock widgets (which leave placeholders behind), then measures serializeLayout(),
+ * restoreLayout(), the cost of each serialization format and the peak memory of each phase.
+ *
+ * Runs with -platform offscreen by default, so it can run on CI machines.
+ *
+ * @author Sérgio Martins \<sergio.martins@kdab.com\>
+ */
+
+// We don't care about performance related checks in the tests
+// clazy:excludeall=ctor-missing-parent-argument,missing-qobject-macro,range-loop,missing-typeinfo,detaching-member,function-args-by-ref,non-pod-global-static,reserve-candidates,qstring-allocations
+
+#include "DockRegistry_p.h"
+#include "LayoutSaver.h"
+#include "DockWidget.h"
+#include "MainWindow.h"
+
+#include <QApplication>
+#include <QCommandLineParser>
+#include <QElapsedTimer>
+#include <QFile>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QDebug>
+
+#if QT_VERSION >= QT_VERSION_CHECK(5, 12, 0)
+# include <QCborValue>
+#endif
+
+#include <algorithm>
+#include <functional>
+#include <iostream>
+
+using namespace KDDockWidgets;
+
+namespace {
+
+struct GeneratorOptions
+{
+    int mainWindows = 1;
+    int floatingWindows = 2;
+    int dockWidgets = 60;
+    int tabsPerFrame = 2;
+    int closedDockWidgets = 10;
+};
+
+struct Measurement
+{
+    QString name;
+    QVector<qint64> nsecs;
+    qint64 bytes = -1;
+    qint64 peakRssKb = -1;
+
+    qint64 percentile(int p) const
+    {
+        if (nsecs.isEmpty())
+            return -1;
+
+        const int index = qMin(nsecs.size() - 1, (nsecs.size() * p) / 100);
+        return nsecs.at(index);
+    }
+
+    QJsonObject toJson() const
+    {
+        QJsonObject obj;
+        obj.insert(QStringLiteral("name"), name);
+        obj.insert(QStringLiteral("iterations"), nsecs.size());
+        obj.insert(QStringLiteral("minNs"), nsecs.isEmpty() ? -1 : nsecs.constFirst());
+        obj.insert(QStringLiteral("medianNs"), percentile(50));
+        obj.insert(QStringLiteral("p90Ns"), percentile(90));
+        obj.insert(QStringLiteral("maxNs"), nsecs.isEmpty() ? -1 : nsecs.constLast());
+        obj.insert(QStringLiteral("bytes"), bytes);
+        obj.insert(QStringLiteral("peakRssKb"), peakRssKb);
+        return obj;
+    }
+};
+
+// Resets the peak resident set size, so the next reading only covers what happens afterwards
+void resetPeakRss()
+{
+#ifdef Q_OS_LINUX
+    QFile f(QStringLiteral("/proc/self/clear_refs"));
+    if (f.open(QIODevice::WriteOnly))
+        f.write("5");
+#endif
+}
+
+// Returns the peak resident set size in kB, or -1 if not supported on this platform
+qint64 peakRssKb()
+{
+#ifdef Q_OS_LINUX
+    QFile f(QStringLiteral("/proc/self/status"));
+    if (f.open(QIODevice::ReadOnly)) {
+        const QList<QByteArray> lines = f.readAll().split('\n');
+        for (const QByteArray &line : lines) {
+            if (line.startsWith("VmHWM:"))
+                return line.mid(6).trimmed().split(' ').constFirst().toLongLong();
+        }
+    }
+#endif
+    return -1;
+}
+
+void processDeferredDeletes()
+{
+    QCoreApplication::processEvents();
+    QCoreApplication::sendPostedEvents(nullptr, QEvent::DeferredDelete);
+}
+
+Measurement measure(const QString &name, int iterations, const std::function<void()> &func)
+{
+    Measurement m;
+    m.name = name;
+    m.nsecs.reserve(iterations);
+
+    resetPeakRss();
+    for (int i = 0; i < iterations; ++i) {
+        QElapsedTimer timer;
+        timer.start();
+        func();
+        m.nsecs.push_back(timer.nsecsElapsed());
+    }
+    m.peakRssKb = peakRssKb();
+
+    std::sort(m.nsecs.begin(), m.nsecs.end());
+    return m;
+}
+
+///@brief Creates the main windows and dock widgets. Frames are distributed round-robin between
+///the main windows and the floating windows, each with @p tabsPerFrame tabs.
+void generateLayout(const GeneratorOptions &opts)
+{
+    QVector<MainWindow*> mainWindows;
+    for (int i = 0; i < opts.mainWindows; ++i) {
+        auto mainWindow = new MainWindow(QStringLiteral("MainWindow-%1").arg(i));
+        mainWindow->resize(1600, 1000);
+        mainWindow->show();
+        mainWindows.push_back(mainWindow);
+    }
+
+    const int numWindows = opts.mainWindows + opts.floatingWindows;
+    const Location locations[] = { Location_OnLeft, Location_OnTop, Location_OnRight, Location_OnBottom };
+
+    QVector<DockWidgetBase*> lastFrameInWindow(numWindows, nullptr);
+    QVector<DockWidgetBase*> dockWidgets;
+    dockWidgets.reserve(opts.dockWidgets);
+
+    DockWidgetBase *frameDockWidget = nullptr;
+    int frameIndex = -1;
+    for (int i = 0; i < opts.dockWidgets; ++i) {
+        auto dw = new DockWidget(QStringLiteral("dock-%1").arg(i));
+        dw->setWidget(new QWidget());
+        dockWidgets.push_back(dw);
+
+        if (i % opts.tabsPerFrame != 0) {
+            frameDockWidget->addDockWidgetAsTab(dw);
+            continue;
+        }
+
+        ++frameIndex;
+        frameDockWidget = dw;
+        const int windowIndex = frameIndex % numWindows;
+        const int round = frameIndex / numWindows;
+        const Location location = locations[round % 4];
+        DockWidgetBase *previous = lastFrameInWindow.at(windowIndex);
+
+        if (windowIndex < opts.mainWindows) {
+            // Alternate between adding to the outer layout and nesting, so we get a deep tree
+            mainWindows.at(windowIndex)->addDockWidget(dw, location, round % 2 ? previous : nullptr);
+        } else if (!previous) {
+            dw->show();
+            dw->window()->move(50 * windowIndex, 50 * windowIndex);
+        } else {
+            previous->addDockWidgetToContainingWindow(dw, location);
+        }
+
+        lastFrameInWindow[windowIndex] = dw;
+    }
+
+    // Closing docked dock widgets leaves placeholders behind
+    int numClosed = 0;
+    for (int i = dockWidgets.size() - 1; i >= 0 && numClosed < opts.closedDockWidgets; --i) {
+        DockWidgetBase *dw = dockWidgets.at(i);
+        if (qobject_cast<MainWindowBase*>(dw->window())) {
+            dw->close();
+            ++numClosed;
+        }
+    }
+
+    processDeferredDeletes();
+}
+
+void printMeasurement(const Measurement &m)
+{
+    const QString line = QStringLiteral("%1 median=%2us p90=%3us min=%4us max=%5us peakRss=%6kB")
+                             .arg(m.name, -28)
+                             .arg(m.percentile(50) / 1000, 8)
+                             .arg(m.percentile(90) / 1000, 8)
+                             .arg(m.nsecs.constFirst() / 1000, 8)
+                             .arg(m.nsecs.constLast() / 1000, 8)
+                             .arg(m.peakRssKb, 8);
+
+    std::cout << line.toStdString();
+    if (m.bytes != -1)
+        std::cout << " size=" << m.bytes << "b";
+    std::cout << "\n";
+}
+
+bool qpaPassedAsArgument(int argc, char *argv[])
+{
+    for (int i = 1; i < argc; ++i) {
+        if (qstrcmp(argv[i], "-platform") == 0)
+            return true;
+    }
+
+    return false;
+}
+
+}
+
+int main(int argc, char **argv)
+{
+    if (!qpaPassedAsArgument(argc, argv)) {
+        // Use offscreen by default as it's less annoying, doesn't create visible windows
+        qputenv("QT_QPA_PLATFORM", "offscreen");
+    }
+
+    QApplication app(argc, argv);
+
+    QCommandLineParser parser;
+    parser.setApplicationDescription(QStringLiteral("LayoutSaver benchmark"));
+
+    QCommandLineOption mainWindowsOption(QStringLiteral("main-windows"), QStringLiteral("Number of main windows"), QStringLiteral("count"), QStringLiteral("1"));
+    QCommandLineOption floatingWindowsOption(QStringLiteral("floating-windows"), QStringLiteral("Number of floating windows"), QStringLiteral("count"), QStringLiteral("2"));
+    QCommandLineOption dockWidgetsOption(QStringLiteral("docks"), QStringLiteral("Total number of dock widgets"), QStringLiteral("count"), QStringLiteral("60"));
+    QCommandLineOption tabsOption(QStringLiteral("tabs"), QStringLiteral("Number of dock widgets per frame"), QStringLiteral("count"), QStringLiteral("2"));
+    QCommandLineOption closedOption(QStringLiteral("closed"), QStringLiteral("Number of closed dock widgets, each leaves a placeholder"), QStringLiteral("count"), QStringLiteral("10"));
+    QCommandLineOption iterationsOption(QStringLiteral("iterations"), QStringLiteral("Number of iterations of each measurement"), QStringLiteral("count"), QStringLiteral("10"));
+    QCommandLineOption outputOption(QStringLiteral("json"), QStringLiteral("Also write the results to a json file"), QStringLiteral("file"));
+
+    parser.addOptions({ mainWindowsOption, floatingWindowsOption, dockWidgetsOption, tabsOption,
+                        closedOption, iterationsOption, outputOption });
+    parser.addHelpOption();
+    parser.process(app);
+
+    GeneratorOptions opts;
+    opts.mainWindows = parser.value(mainWindowsOption).toInt();
+    opts.floatingWindows = parser.value(floatingWindowsOption).toInt();
+    opts.dockWidgets = parser.value(dockWidgetsOption).toInt();
+    opts.tabsPerFrame = parser.value(tabsOption).toInt();
+    opts.closedDockWidgets = parser.value(closedOption).toInt();
+    const int iterations = parser.value(iterationsOption).toInt();
+
+    if (opts.mainWindows + opts.floatingWindows < 1 || opts.tabsPerFrame < 1 || iterations < 1
+        || opts.mainWindows < 0 || opts.floatingWindows < 0 || opts.dockWidgets < 0) {
+        std::cerr << "Invalid arguments\n";
+        return 1;
+    }
+
+    app.setQuitOnLastWindowClosed(false);
+
+    resetPeakRss();
+    QElapsedTimer generationTimer;
+    generationTimer.start();
+    generateLayout(opts);
+    const qint64 generationNs = generationTimer.nsecsElapsed();
+    const qint64 generationPeakRssKb = peakRssKb();
+
+    QVector<Measurement> measurements;
+    LayoutSaver saver;
+
+    QByteArray serialized;
+    measurements.push_back(measure(QStringLiteral("serializeLayout"), iterations, [&saver, &serialized] {
+        serialized = saver.serializeLayout();
+    }));
+    measurements.last().bytes = serialized.size();
+
+    // Compare the formats on the same document, so the cost of building it isn't included
+    const QJsonDocument doc = QJsonDocument::fromJson(serialized);
+    const QJsonDocument::JsonFormat jsonFormats[] = { QJsonDocument::Indented, QJsonDocument::Compact };
+    for (QJsonDocument::JsonFormat format : jsonFormats) {
+        const QString name = format == QJsonDocument::Indented ? QStringLiteral("json-indented")
+                                                               : QStringLiteral("json-compact");
+        QByteArray encoded;
+        measurements.push_back(measure(name + QStringLiteral(" encode"), iterations, [&doc, &encoded, format] {
+            encoded = doc.toJson(format);
+        }));
+        measurements.last().bytes = encoded.size();
+
+        QJsonDocument decoded;
+        measurements.push_back(measure(name + QStringLiteral(" decode"), iterations, [&encoded, &decoded] {
+            decoded = QJsonDocument::fromJson(encoded);
+        }));
+    }
+
+#if QT_VERSION >= QT_VERSION_CHECK(5, 12, 0)
+    QByteArray cbor;
+    const QJsonObject rootObject = doc.object();
+    measurements.push_back(measure(QStringLiteral("cbor encode"), iterations, [&rootObject, &cbor] {
+        cbor = QCborValue::fromJsonValue(rootObject).toCbor();
+    }));
+    measurements.last().bytes = cbor.size();
+
+    QJsonValue decoded;
+    measurements.push_back(measure(QStringLiteral("cbor decode"), iterations, [&cbor, &decoded] {
+        decoded = QCborValue::fromCbor(cbor).toJsonValue();
+    }));
+#endif
+
+    bool restoreOk = true;
+    measurements.push_back(measure(QStringLiteral("restoreLayout"), iterations, [&saver, &serialized, &restoreOk] {
+        restoreOk = saver.restoreLayout(serialized) && restoreOk;
+    }));
+
+    processDeferredDeletes();
+
+    DockRegistry *registry = DockRegistry::self();
+    const int numWidgets = QApplication::allWidgets().size();
+    const int numFrames = registry->frames().size();
+    const int numFloatingWindows = registry->floatingWindows().size();
+
+    std::cout << "Generated " << opts.mainWindows << " main windows, " << numFloatingWindows
+              << " floating windows, " << registry->dockwidgets().size() << " dock widgets ("
+              << opts.closedDockWidgets << " closed), " << numFrames << " frames in "
+              << generationNs / 1000000 << "ms, peakRss=" << generationPeakRssKb << "kB\n";
+    std::cout << "Restored layout has " << numWidgets << " widgets\n";
+
+    for (const Measurement &m : qAsConst(measurements))
+        printMeasurement(m);
+
+    if (parser.isSet(outputOption)) {
+        QJsonArray results;
+        for (const Measurement &m : qAsConst(measurements))
+            results.push_back(m.toJson());
+
+        QJsonObject root;
+        root.insert(QStringLiteral("mainWindows"), opts.mainWindows);
+        root.insert(QStringLiteral("floatingWindows"), numFloatingWindows);
+        root.insert(QStringLiteral("dockWidgets"), opts.dockWidgets);
+        root.insert(QStringLiteral("tabsPerFrame"), opts.tabsPerFrame);
+        root.insert(QStringLiteral("closedDockWidgets"), opts.closedDockWidgets);
+        root.insert(QStringLiteral("frames"), numFrames);
+        root.insert(QStringLiteral("widgets"), numWidgets);
+        root.insert(QStringLiteral("restoreSucceeded"), restoreOk);
+        root.insert(QStringLiteral("results"), results);
+
+        QFile f(parser.value(outputOption));
+        if (!f.open(QIODevice::WriteOnly)) {
+            std::cerr << "Failed to write " << f.fileName().toStdString() << "\n";
+            return 1;
+        }
+        f.write(QJsonDocument(root).toJson());
+    }
+
+    qDeleteAll(registry->mainwindows());
+    qDeleteAll(registry->dockwidgets());
+    processDeferredDeletes();
+
+    if (!restoreOk) {
+        std::cerr << "Failed to restore the layout\n";
+        return 1;
+    }
+
+    return 0;
+}
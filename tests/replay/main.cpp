@@ -0,0 +1,255 @@
+/*
+  This file is part of KDDockWidgets.
+
+  SPDX-FileCopyrightText: 2019-2020 Klarälvdalens Datakonsult AB, a KDAB Group company <info@kdab.com>
+  Author: Sérgio Martins <sergio.martins@kdab.com>
+
+  SPDX-License-Identifier: GPL-2.0-only OR GPL-3.0-only
+
+  Contact KDAB at <info@kdab.com> for commercial licensing options.
+*/
+
+/**
+ * @file
+ * @brief Replays mouse events recorded with KDDOCKWIDGETS_RECORD_EVENTS and reports their cost.
+ *
+ * Restores the layout the recording started with, sends each recorded event and measures how long
+ * it took to process. Prints statistics per event type, the slowest events and a checksum of the
+ * final layout, which can be compared between runs with --expect-checksum.
+ *
+ * Runs with -platform offscreen by default, so it can run on CI machines.
+ *
+ * @author Sérgio Martins \<sergio.martins@kdab.com\>
+ */
+
+// We don't care about performance related checks in the tests
+// clazy:excludeall=ctor-missing-parent-argument,missing-qobject-macro,range-loop,missing-typeinfo,detaching-member,function-args-by-ref,non-pod-global-static,reserve-candidates,qstring-allocations
+
+#include "DockRegistry_p.h"
+#include "EventRecorder_p.h"
+#include "../utils.h"
+
+#include <QApplication>
+#include <QCommandLineParser>
+#include <QFile>
+#include <QHash>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QDebug>
+
+#include <algorithm>
+#include <iostream>
+#include <numeric>
+
+using namespace KDDockWidgets;
+using namespace KDDockWidgets::Debug;
+
+namespace {
+
+QString nameForEventType(QEvent::Type type)
+{
+    switch (type) {
+    case QEvent::MouseButtonPress:
+        return QStringLiteral("press");
+    case QEvent::MouseButtonRelease:
+        return QStringLiteral("release");
+    case QEvent::MouseButtonDblClick:
+        return QStringLiteral("doubleclick");
+    case QEvent::MouseMove:
+        return QStringLiteral("move");
+    case QEvent::NonClientAreaMouseButtonPress:
+        return QStringLiteral("ncpress");
+    case QEvent::NonClientAreaMouseButtonRelease:
+        return QStringLiteral("ncrelease");
+    case QEvent::NonClientAreaMouseMove:
+        return QStringLiteral("ncmove");
+    default:
+        break;
+    }
+
+    return QString::number(int(type));
+}
+
+struct TypeStatistics
+{
+    QString name;
+    QVector<qint64> nsecs; // sorted
+
+    qint64 percentile(int p) const
+    {
+        const int index = qMin(nsecs.size() - 1, (nsecs.size() * p) / 100);
+        return nsecs.at(index);
+    }
+
+    qint64 total() const
+    {
+        qint64 sum = 0;
+        for (qint64 n : nsecs)
+            sum += n;
+        return sum;
+    }
+
+    QJsonObject toJson() const
+    {
+        QJsonObject obj;
+        obj.insert(QStringLiteral("type"), name);
+        obj.insert(QStringLiteral("count"), nsecs.size());
+        obj.insert(QStringLiteral("medianNs"), percentile(50));
+        obj.insert(QStringLiteral("p90Ns"), percentile(90));
+        obj.insert(QStringLiteral("p99Ns"), percentile(99));
+        obj.insert(QStringLiteral("maxNs"), nsecs.constLast());
+        obj.insert(QStringLiteral("totalNs"), total());
+        return obj;
+    }
+};
+
+void processDeferredDeletes()
+{
+    QCoreApplication::processEvents();
+    QCoreApplication::sendPostedEvents(nullptr, QEvent::DeferredDelete);
+}
+
+}
+
+int main(int argc, char **argv)
+{
+    if (!qpaPassedAsArgument(argc, argv)) {
+        // Use offscreen by default as it's less annoying, doesn't create visible windows
+        qputenv("QT_QPA_PLATFORM", "offscreen");
+    }
+
+    QApplication app(argc, argv);
+
+    QCommandLineParser parser;
+    parser.setApplicationDescription(QStringLiteral("Replays a recording made with KDDOCKWIDGETS_RECORD_EVENTS"));
+    parser.addPositionalArgument(QStringLiteral("recording"), QStringLiteral("The recorded json file"));
+
+    QCommandLineOption honorTimingOption(QStringLiteral("honor-timing"), QStringLiteral("Wait between events as long as the user did"));
+    QCommandLineOption slowestOption(QStringLiteral("slowest"), QStringLiteral("Number of slowest events to print"), QStringLiteral("count"), QStringLiteral("10"));
+    QCommandLineOption outputOption(QStringLiteral("json"), QStringLiteral("Also write the results to a json file"), QStringLiteral("file"));
+    QCommandLineOption checksumOption(QStringLiteral("expect-checksum"), QStringLiteral("Fail if the final layout has a different checksum"), QStringLiteral("sha1"));
+
+    parser.addOptions({ honorTimingOption, slowestOption, outputOption, checksumOption });
+    parser.addHelpOption();
+    parser.process(app);
+
+    const QStringList positional = parser.positionalArguments();
+    if (positional.size() != 1) {
+        std::cerr << "Expected a single recording file\n";
+        return 1;
+    }
+
+    QFile f(positional.constFirst());
+    if (!f.open(QIODevice::ReadOnly)) {
+        std::cerr << "Failed to open " << f.fileName().toStdString() << "\n";
+        return 1;
+    }
+
+    EventReplayer replayer;
+    if (!replayer.load(f.readAll()) || !replayer.restoreLayout()) {
+        std::cerr << "Failed to restore the recorded layout\n";
+        return 1;
+    }
+
+    app.setQuitOnLastWindowClosed(false);
+    processDeferredDeletes();
+
+    const QVector<EventReplayer::EventTiming> timings = replayer.replay(parser.isSet(honorTimingOption));
+    processDeferredDeletes();
+    const QByteArray checksum = EventReplayer::layoutChecksum();
+
+    QHash<QEvent::Type, TypeStatistics> statisticsPerType;
+    qint64 totalNs = 0;
+    for (const EventReplayer::EventTiming &timing : timings) {
+        TypeStatistics &stats = statisticsPerType[timing.type];
+        stats.name = nameForEventType(timing.type);
+        stats.nsecs.push_back(timing.nsecs);
+        totalNs += timing.nsecs;
+    }
+
+    QVector<TypeStatistics> statistics;
+    for (TypeStatistics &stats : statisticsPerType) {
+        std::sort(stats.nsecs.begin(), stats.nsecs.end());
+        statistics.push_back(stats);
+    }
+    std::sort(statistics.begin(), statistics.end(), [](const TypeStatistics &s1, const TypeStatistics &s2) {
+        return s1.name < s2.name;
+    });
+
+    std::cout << "Replayed " << timings.size() << " of " << replayer.numEvents() << " events in "
+              << totalNs / 1000000 << "ms\n";
+
+    for (const TypeStatistics &stats : qAsConst(statistics)) {
+        const QString line = QStringLiteral("%1 count=%2 median=%3us p90=%4us p99=%5us max=%6us total=%7us")
+                                 .arg(stats.name, -12)
+                                 .arg(stats.nsecs.size(), 6)
+                                 .arg(stats.percentile(50) / 1000, 8)
+                                 .arg(stats.percentile(90) / 1000, 8)
+                                 .arg(stats.percentile(99) / 1000, 8)
+                                 .arg(stats.nsecs.constLast() / 1000, 8)
+                                 .arg(stats.total() / 1000, 8);
+        std::cout << line.toStdString() << "\n";
+    }
+
+    // The slowest events, with their index among the replayed events
+    QVector<int> indexes(timings.size());
+    std::iota(indexes.begin(), indexes.end(), 0);
+    std::sort(indexes.begin(), indexes.end(), [&timings](int i1, int i2) {
+        return timings.at(i1).nsecs > timings.at(i2).nsecs;
+    });
+    indexes.resize(qMin(indexes.size(), qMax(0, parser.value(slowestOption).toInt())));
+
+    QJsonArray slowest;
+    if (!indexes.isEmpty())
+        std::cout << "Slowest events:\n";
+    for (int index : qAsConst(indexes)) {
+        const EventReplayer::EventTiming &timing = timings.at(index);
+        std::cout << "  #" << index << " " << nameForEventType(timing.type).toStdString()
+                  << " at " << timing.globalPos.x() << "," << timing.globalPos.y()
+                  << " " << timing.nsecs / 1000 << "us\n";
+
+        QJsonObject obj;
+        obj.insert(QStringLiteral("index"), index);
+        obj.insert(QStringLiteral("type"), nameForEventType(timing.type));
+        obj.insert(QStringLiteral("x"), timing.globalPos.x());
+        obj.insert(QStringLiteral("y"), timing.globalPos.y());
+        obj.insert(QStringLiteral("nsecs"), timing.nsecs);
+        slowest.push_back(obj);
+    }
+
+    std::cout << "Layout checksum: " << checksum.constData() << "\n";
+
+    if (parser.isSet(outputOption)) {
+        QJsonArray results;
+        for (const TypeStatistics &stats : qAsConst(statistics))
+            results.push_back(stats.toJson());
+
+        QJsonObject root;
+        root.insert(QStringLiteral("events"), replayer.numEvents());
+        root.insert(QStringLiteral("replayedEvents"), timings.size());
+        root.insert(QStringLiteral("totalNs"), totalNs);
+        root.insert(QStringLiteral("results"), results);
+        root.insert(QStringLiteral("slowest"), slowest);
+        root.insert(QStringLiteral("layoutChecksum"), QString::fromLatin1(checksum));
+
+        QFile out(parser.value(outputOption));
+        if (!out.open(QIODevice::WriteOnly)) {
+            std::cerr << "Failed to write " << out.fileName().toStdString() << "\n";
+            return 1;
+        }
+        out.write(QJsonDocument(root).toJson());
+    }
+
+    DockRegistry *registry = DockRegistry::self();
+    qDeleteAll(registry->mainwindows());
+    qDeleteAll(registry->dockwidgets());
+    processDeferredDeletes();
+
+    if (parser.isSet(checksumOption) && parser.value(checksumOption).toLatin1() != checksum) {
+        std::cerr << "Unexpected layout checksum, expected " << parser.value(checksumOption).toStdString() << "\n";
+        return 2;
+    }
+
+    return 0;
+}
@@ -21,12 +21,26 @@
 #include "Position_p.h"
 #include "DropAreaWithCentralFrame_p.h"
 #include "WindowBeingDragged_p.h"
+#include "DragController_p.h"
 #include "Config.h"
 #include "SideBar_p.h"
+#include "LayoutAutoSaver.h"
+#include "LayoutLibrary.h"
+#include "EventRecorder_p.h"
+#ifdef KDDOCKWIDGETS_QTWIDGETS
+# include "indicators/SegmentedIndicators_p.h"
+# include "FloatingWindowPool_p.h"
+# include "FramePool_p.h"
+# include "widgets/TabWidgetWidget_p.h"
+#endif
 
 #include <QtTest/QtTest>
 #include <QObject>
 #include <QAction>
+#include <QDataStream>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QJsonObject>
 #include <QStyleFactory>
 
 #ifdef KDDOCKWIDGETS_QTQUICK
@@ -40,9 +54,11 @@
 # include "MainWindow.h"
 
 # include <QPushButton>
+# include <QLabel>
 # include <QLineEdit>
 # include <QTextEdit>
 # include <QTabBar>
+# include <QMenu>
 # include <QMenuBar>
 #endif
 
@@ -110,6 +126,9 @@ private Q_SLOTS:
     void tst_floatingWindowTitleBug();
     void tst_setFloatingSimple();
     void tst_dragOverTitleBar();
+    void tst_dropAreaIndex();
+    void tst_coalescedDragHover();
+    void tst_dragStatistics();
 
     void tst_resizeWindow_data();
     void tst_resizeWindow();
@@ -134,6 +153,8 @@ private Q_SLOTS:
     void tst_lastFloatingPositionIsRestored();
     void tst_restoreSimple();
     void tst_restoreSimplest();
+    void tst_layoutAutoSaver();
+    void tst_layoutLibrary();
     void tst_invalidLayoutAfterRestore();
 
     void tst_propagateResize2();
@@ -162,6 +183,7 @@ private Q_SLOTS:
     void tst_setAsCurrentTab();
     void tst_placeholderDisappearsOnReadd();
     void tst_placeholdersAreRemovedProperly();
+    void tst_compactLayout();
     void tst_floatMaintainsSize();
 
     void tst_crash2_data();
@@ -252,6 +274,23 @@ private Q_SLOTS:
     void tst_negativeAnchorPositionWhenEmbedded_data();
     void tst_closeRemovesFromSideBar();
     void tst_restoreSideBar();
+    void tst_deferredDetach();
+    void tst_deferredDetachOutterDrop();
+    void tst_eventRecorder();
+    void tst_sharedIndicatorWindow();
+    void tst_segmentedIndicatorsHitTest();
+    void tst_frameContainingPos();
+    void tst_floatingWindowPool();
+    void tst_widgetFactory();
+    void tst_hibernation();
+    void tst_framePool();
+    void tst_coalescedTitleUpdates();
+    void tst_cachedSizeConstraints();
+    void tst_uniformTabWidths();
+    void tst_overlayFrameReused();
+    void tst_dropAreaIndexSkipsOverlay();
+    void tst_bulkClear();
+    void tst_fastTeardown();
 
     // And fix these
     void tst_floatingWindowDeleted();
@@ -840,7 +879,7 @@ void TestDocks::tst_nonDockable()
 
         TitleBar *tb = dock->titleBar();
         QVERIFY(tb->isVisible());
-        QVERIFY(tb->isFloatButtonVisible());
+        QTRY_VERIFY(tb->isFloatButtonVisible());
 
         delete dock->window();
     }
@@ -852,7 +891,7 @@ void TestDocks::tst_nonDockable()
 
         TitleBar *tb = dock->titleBar();
         QVERIFY(tb->isVisible());
-        QVERIFY(!tb->isFloatButtonVisible());
+        QTRY_VERIFY(!tb->isFloatButtonVisible());
 
         delete dock->window();
     }
@@ -2178,6 +2217,48 @@ void TestDocks::tst_placeholderDisappearsOnReadd()
     QVERIFY(Testing::waitForDeleted(fw));
 }
 
+void TestDocks::tst_compactLayout()
+{
+    EnsureTopLevelsDeleted e;
+    auto m = createMainWindow(QSize(1000, 1000), MainWindowOption_None);
+    MultiSplitter *layout = m->multiSplitter();
+    auto dock1 = createDockWidget("1", new QPushButton("1"));
+    auto dock2 = createDockWidget("2", new QPushButton("2"));
+    auto dock3 = createDockWidget("3", new QPushButton("3"));
+    m->addDockWidget(dock1, Location_OnLeft);
+    m->addDockWidget(dock2, Location_OnRight);
+    m->addDockWidget(dock3, Location_OnBottom);
+
+    QPointer<Frame> frame1 = dock1->frame();
+    QPointer<Frame> frame2 = dock2->frame();
+    dock1->close();
+    QVERIFY(Testing::waitForDeleted(frame1));
+    QTest::qWait(50); // So dock2's placeholder is younger
+    dock2->close();
+    QVERIFY(Testing::waitForDeleted(frame2));
+    QCOMPARE(layout->placeholderCount(), 2);
+
+    // Both placeholders can still be restored, nothing to compact
+    QCOMPARE(m->compactLayout(), 0);
+    QCOMPARE(layout->placeholderCount(), 2);
+
+    // Only the most recently closed one is kept
+    Config::self().setMaxPlaceholderCount(1);
+    QCOMPARE(m->compactLayout(), 1);
+    Config::self().setMaxPlaceholderCount(0);
+    QCOMPARE(layout->placeholderCount(), 1);
+    QVERIFY(layout->checkSanity());
+    QVERIFY(!dock1->lastPositions().isValid());
+    QVERIFY(dock2->lastPositions().isValid());
+
+    dock2->show();
+    QCOMPARE(dock2->window(), m.get());
+    QCOMPARE(layout->placeholderCount(), 0);
+    QVERIFY(layout->checkSanity());
+
+    delete dock1;
+}
+
 void TestDocks::tst_placeholdersAreRemovedProperly()
 {
     EnsureTopLevelsDeleted e;
@@ -3435,6 +3516,173 @@ void TestDocks::tst_restoreSimplest()
    QVERIFY(layout->checkSanity());
 }
 
+void TestDocks::tst_layoutAutoSaver()
+{
+    EnsureTopLevelsDeleted e;
+    auto m = createMainWindow(QSize(800, 500), MainWindowOption_None);
+    auto layout = m->multiSplitter();
+    auto dock1 = createDockWidget("one", Qt::red);
+    auto dock2 = createDockWidget("two", Qt::blue);
+    m->addDockWidget(dock1, Location_OnTop);
+    m->addDockWidget(dock2, Location_OnBottom);
+
+    const QString fileName = QStringLiteral("layout_tst_layoutAutoSaver.json");
+    const QString journalName = LayoutAutoSaver::journalFileName(fileName);
+    QFile::remove(fileName);
+    QFile::remove(journalName);
+
+    {
+        LayoutAutoSaver autoSaver(fileName);
+        autoSaver.setJournalingEnabled(true);
+
+        // The first save is always a full write
+        QVERIFY(autoSaver.saveNow());
+        autoSaver.waitForPendingSaves();
+        QVERIFY(QFile::exists(fileName));
+        QVERIFY(!QFile::exists(journalName));
+
+        // Subsequent ones only journal what changed
+        dock2->close();
+        QVERIFY(autoSaver.saveNow());
+        autoSaver.waitForPendingSaves();
+        QVERIFY(QFile::exists(journalName));
+
+        QByteArray staleJournal;
+        {
+            QFile journal(journalName);
+            QVERIFY(journal.open(QIODevice::ReadOnly));
+            staleJournal = journal.readAll();
+        }
+
+        auto isClosedIn = [] (const QByteArray &data) {
+            const QJsonArray closed = QJsonDocument::fromJson(data).object().value(QStringLiteral("closedDockWidgets")).toArray();
+            return closed.contains(QStringLiteral("two"));
+        };
+        QVERIFY(isClosedIn(LayoutAutoSaver::recoveredLayout(fileName)));
+
+        // A full write, which removes the journal
+        autoSaver.setJournalCompactionThreshold(1);
+        dock2->show();
+        QVERIFY(autoSaver.saveNow());
+        autoSaver.waitForPendingSaves();
+        QVERIFY(!QFile::exists(journalName));
+
+        // As if we crashed before the journal was removed. Its entries are older than the main file.
+        {
+            QFile journal(journalName);
+            QVERIFY(journal.open(QIODevice::WriteOnly));
+            journal.write(staleJournal);
+        }
+        QVERIFY(!isClosedIn(LayoutAutoSaver::recoveredLayout(fileName)));
+
+        // New entries are still applied
+        dock2->close();
+        QVERIFY(autoSaver.saveNow());
+        autoSaver.waitForPendingSaves();
+        QVERIFY(isClosedIn(LayoutAutoSaver::recoveredLayout(fileName)));
+    }
+
+    dock2->show();
+    QVERIFY(dock2->isFloating());
+    QPointer<FloatingWindow> fw = dock2->floatingWindow();
+
+    LayoutSaver saver;
+    QVERIFY(saver.restoreLayout(LayoutAutoSaver::recoveredLayout(fileName)));
+    QVERIFY(layout->checkSanity());
+    QVERIFY(!dock2->isVisible());
+    QVERIFY(dock1->isVisible());
+    if (fw)
+        Testing::waitForDeleted(fw);
+
+    delete dock2;
+}
+
+void TestDocks::tst_layoutLibrary()
+{
+    EnsureTopLevelsDeleted e;
+    auto m = createMainWindow(QSize(800, 500), MainWindowOption_None);
+    auto layout = m->multiSplitter();
+    auto dock1 = createDockWidget("one", Qt::red);
+    auto dock2 = createDockWidget("two", Qt::blue);
+    m->addDockWidget(dock1, Location_OnTop);
+    m->addDockWidget(dock2, Location_OnBottom);
+
+    const QString fileName = QStringLiteral("layout_tst_layoutLibrary.kddl");
+    QFile::remove(fileName);
+
+    {
+        LayoutLibrary library(fileName);
+        QVERIFY(library.open());
+        QVERIFY(library.presetNames().isEmpty());
+
+        QVERIFY(library.savePreset(QStringLiteral("both")));
+        dock2->close();
+        QVERIFY(library.savePreset(QStringLiteral("onlyOne")));
+        QCOMPARE(library.presetNames(), QStringList({ QStringLiteral("both"), QStringLiteral("onlyOne") }));
+        QCOMPARE(library.presetSerializationVersion(QStringLiteral("both")), KDDOCKWIDGETS_SERIALIZATION_VERSION);
+    }
+
+    LayoutLibrary library(fileName);
+    QVERIFY(library.open());
+    QCOMPARE(library.presetNames().size(), 2);
+
+    QVERIFY(library.restorePreset(QStringLiteral("both")));
+    QVERIFY(layout->checkSanity());
+    QVERIFY(dock2->isVisible());
+
+    QVERIFY(library.restorePreset(QStringLiteral("onlyOne")));
+    QVERIFY(layout->checkSanity());
+    QVERIFY(!dock2->isVisible());
+
+    QVERIFY(library.removePreset(QStringLiteral("both")));
+    QCOMPARE(library.presetNames(), QStringList({ QStringLiteral("onlyOne") }));
+    QVERIFY(!library.contains(QStringLiteral("both")));
+
+    // A file which can't be read isn't overwritten with only the new preset
+    const QString invalidFileName = QStringLiteral("layout_tst_layoutLibrary_invalid.kddl");
+    const QByteArray garbage("not a layout library");
+    {
+        QFile f(invalidFileName);
+        QVERIFY(f.open(QIODevice::WriteOnly));
+        f.write(garbage);
+    }
+
+    LayoutLibrary invalidLibrary(invalidFileName);
+    {
+        SetExpectedWarning ignoreWarning("Invalid layout library");
+        QVERIFY(!invalidLibrary.open());
+    }
+    {
+        SetExpectedWarning ignoreWarning("Refusing to modify unreadable layout library");
+        QVERIFY(!invalidLibrary.savePreset(QStringLiteral("both")));
+    }
+
+    QFile f(invalidFileName);
+    QVERIFY(f.open(QIODevice::ReadOnly));
+    QCOMPARE(f.readAll(), garbage);
+    f.close();
+
+    // A valid header, but an entry whose offset + size overflows back into the file
+    {
+        QFile crafted(invalidFileName);
+        QVERIFY(crafted.open(QIODevice::WriteOnly));
+        QDataStream ds(&crafted);
+        ds.setVersion(QDataStream::Qt_5_9);
+        ds << quint32(0x4B44444C) << quint32(1) << quint32(1); // magic, version, count
+        ds << QStringLiteral("crafted") << qint32(KDDOCKWIDGETS_SERIALIZATION_VERSION)
+           << quint64(0xFFFFFFFFFFFFFFF0ULL) << quint64(0x20);
+    }
+
+    LayoutLibrary craftedLibrary(invalidFileName);
+    {
+        SetExpectedWarning ignoreWarning("Invalid layout library");
+        QVERIFY(!craftedLibrary.open());
+    }
+    QVERIFY(!craftedLibrary.contains(QStringLiteral("crafted")));
+
+    delete dock2;
+}
+
 void TestDocks::tst_resizeViaAnchorsAfterPlaceholderCreation()
 {
     EnsureTopLevelsDeleted e;
@@ -3940,10 +4188,10 @@ void TestDocks::tst_notClosable()
         QVERIFY(fw);
         TitleBar *titlebarFW = fw->titleBar();
         TitleBar *titleBarFrame = fw->frames().at(0)->titleBar();
-        QVERIFY(titlebarFW->isCloseButtonVisible());
-        QVERIFY(!titlebarFW->isCloseButtonEnabled());
-        QVERIFY(!titleBarFrame->isCloseButtonVisible());
-        QVERIFY(!titleBarFrame->isCloseButtonEnabled());
+        QTRY_VERIFY(titlebarFW->isCloseButtonVisible());
+        QTRY_VERIFY(!titlebarFW->isCloseButtonEnabled());
+        QTRY_VERIFY(!titleBarFrame->isCloseButtonVisible());
+        QTRY_VERIFY(!titleBarFrame->isCloseButtonEnabled());
 
         dock1->setOptions(DockWidgetBase::Option_None);
         QVERIFY(titlebarFW->isCloseButtonVisible());
@@ -3976,9 +4224,9 @@ void TestDocks::tst_notClosable()
         TitleBar *titlebarFW = fw->titleBar();
         TitleBar *titleBarFrame = fw->frames().at(0)->titleBar();
 
-        QVERIFY(titlebarFW->isCloseButtonVisible());
-        QVERIFY(!titleBarFrame->isCloseButtonVisible());
-        QVERIFY(!titleBarFrame->isCloseButtonEnabled());
+        QTRY_VERIFY(titlebarFW->isCloseButtonVisible());
+        QTRY_VERIFY(!titleBarFrame->isCloseButtonVisible());
+        QTRY_VERIFY(!titleBarFrame->isCloseButtonEnabled());
 
         auto window = dock2->window();
         window->deleteLater();
@@ -4008,6 +4256,117 @@ void TestDocks::tst_dragOverTitleBar()
     delete fw2;
 }
 
+void TestDocks::tst_dropAreaIndex()
+{
+    EnsureTopLevelsDeleted e;
+    auto m = createMainWindow(QSize(800, 500), MainWindowOption_None);
+    auto dock1 = createDockWidget("dock1", new QPushButton("one"));
+    m->addDockWidget(dock1, Location_OnLeft);
+    auto dock2 = createDockWidget("dock2", new QPushButton("two"));
+    FloatingWindow *fw2 = dock2->floatingWindow();
+
+    DropAreaIndex index;
+    WindowBeingDragged wbd(fw2);
+    index.rebuild(&wbd, nullptr);
+    QVERIFY(index.isValid());
+
+    // The window being dragged is excluded, even if it's on top of the main window
+    const QPoint center = m->dropArea()->mapToGlobal(m->dropArea()->rect().center());
+    WidgetType *topLevel = index.topLevelAt(center);
+    QVERIFY(topLevel);
+    QVERIFY(topLevel != fw2);
+    QVERIFY(index.containsTopLevel(topLevel));
+    QCOMPARE(index.dropAreaAt(topLevel, center), m->dropArea());
+    QVERIFY(!index.topLevelAt(QPoint(-10000, -10000)));
+
+#ifdef KDDOCKWIDGETS_QTWIDGETS
+    // The drop area moves inside its window, which isn't moved nor resized. The index must notice.
+    const QRect oldDropAreaRect(m->dropArea()->mapToGlobal(QPoint(0, 0)), m->dropArea()->size());
+    const QPoint oldLeft = oldDropAreaRect.topLeft() + QPoint(50, 50);
+    m->centralWidget()->layout()->setContentsMargins(200, 0, 0, 0);
+    QTRY_VERIFY(m->dropArea()->mapToGlobal(QPoint(0, 0)).x() > oldLeft.x());
+    QVERIFY(index.isValid());
+    QCOMPARE(index.topLevelAt(oldLeft), topLevel);
+    QVERIFY(!index.dropAreaAt(topLevel, oldLeft));
+    const QPoint newCenter = m->dropArea()->mapToGlobal(m->dropArea()->rect().center());
+    QCOMPARE(index.dropAreaAt(topLevel, newCenter), m->dropArea());
+#endif
+
+    index.invalidate();
+    QVERIFY(!index.isValid());
+    index.clear();
+    QVERIFY(!index.containsTopLevel(topLevel));
+
+    delete fw2;
+}
+
+void TestDocks::tst_coalescedDragHover()
+{
+    EnsureTopLevelsDeleted e;
+    Config::self().setFlags(Config::self().flags() | Config::Flag_CoalesceDragHover);
+
+    auto m = createMainWindow(QSize(800, 500), MainWindowOption_None);
+    auto dock1 = createDockWidget("dock1", new QPushButton("one"));
+    m->addDockWidget(dock1, Location_OnLeft);
+    auto dock2 = createDockWidget("dock2", new QPushButton("two"));
+    QPointer<FloatingWindow> fw2 = dock2->floatingWindow();
+
+    const QPoint dest = m->dropArea()->mapToGlobal(m->dropArea()->rect().center());
+    dragFloatingWindowTo(fw2, dest, ButtonAction_Press);
+
+    // The window follows every move, but moves arrive every couple of ms, so hover passes
+    // are coalesced
+    DragController *dc = DragController::instance();
+    QVERIFY(dc->isDragging());
+    QVERIFY(dc->dragMouseMoveCount() > 1);
+    QVERIFY(dc->dragHoverPassCount() >= 1);
+    QVERIFY(dc->dragHoverPassCount() < dc->dragMouseMoveCount());
+
+    releaseOn(dest, draggableFor(fw2));
+    QVERIFY(!dc->isDragging());
+
+    if (fw2)
+        delete fw2;
+}
+
+void TestDocks::tst_dragStatistics()
+{
+    EnsureTopLevelsDeleted e;
+    auto m = createMainWindow(QSize(800, 500), MainWindowOption_None);
+    auto dock1 = createDockWidget("dock1", new QPushButton("one"));
+    m->addDockWidget(dock1, Location_OnLeft);
+    auto dock2 = createDockWidget("dock2", new QPushButton("two"));
+    QPointer<FloatingWindow> fw2 = dock2->floatingWindow();
+
+    const QPoint dest = m->dropArea()->mapToGlobal(m->dropArea()->rect().center());
+    dragFloatingWindowTo(fw2, dest, ButtonAction_Press);
+
+    DragController *dc = DragController::instance();
+    const DragStatistics &stats = dc->dragStatistics();
+    QCOMPARE(stats.count(DragStatistics::Phase_MouseMove), dc->dragMouseMoveCount());
+    QVERIFY(stats.count(DragStatistics::Phase_WindowMove) <= dc->dragMouseMoveCount()); // Not with native moves
+    QCOMPARE(stats.count(DragStatistics::Phase_HitTest), dc->dragHoverPassCount());
+    QVERIFY(stats.count(DragStatistics::Phase_Hover) > 0);
+    QCOMPARE(stats.count(DragStatistics::Phase_Indicators), stats.count(DragStatistics::Phase_Hover));
+    QCOMPARE(stats.count(DragStatistics::Phase_Drop), 0);
+
+    const qint64 p50 = stats.percentile(DragStatistics::Phase_MouseMove, 50);
+    const qint64 max = stats.percentile(DragStatistics::Phase_MouseMove, 100);
+    QVERIFY(p50 > 0);
+    QVERIFY(p50 <= stats.percentile(DragStatistics::Phase_MouseMove, 99));
+    QVERIFY(stats.percentile(DragStatistics::Phase_MouseMove, 99) <= max);
+    QVERIFY(max <= stats.total(DragStatistics::Phase_MouseMove));
+
+    // Still available after the drag ends
+    releaseOn(dest, draggableFor(fw2));
+    QVERIFY(!dc->isDragging());
+    QCOMPARE(stats.count(DragStatistics::Phase_Drop), 1);
+    QVERIFY(!stats.summary().isEmpty());
+
+    if (fw2)
+        delete fw2;
+}
+
 void TestDocks::tst_setFloatingAfterDraggedFromTabToSideBySide()
 {
     EnsureTopLevelsDeleted e;
@@ -5590,8 +5949,880 @@ void TestDocks::tst_fixedSizePolicy()
     delete dock1->window();
 }
 
+void TestDocks::tst_deferredDetach()
+{
+    EnsureTopLevelsDeleted e;
+    Config::self().setFlags(Config::self().flags() | Config::Flag_DeferredDetach);
+
+    auto m = createMainWindow(QSize(800, 500), MainWindowOption_None);
+    auto dock1 = createDockWidget("dock1", new QPushButton("one"));
+    auto dock2 = createDockWidget("dock2", new QPushButton("two"));
+    m->addDockWidget(dock1, Location_OnLeft);
+    m->addDockWidget(dock2, Location_OnRight);
+    auto dropArea = m->dropArea();
+    TitleBar *titleBar = dock2->frame()->titleBar();
+    DragController *dc = DragController::instance();
+
+    // 1. Drop it back onto itself. Nothing is detached, not even while dragging
+    const QPoint inPlace = dock2->frame()->mapToGlobal(dock2->frame()->rect().center());
+    drag(titleBar, titleBar->mapToGlobal(QPoint(6, 6)), inPlace, ButtonAction_Press);
+    QVERIFY(dc->isDragging());
+    QVERIFY(!dc->floatingWindowBeingDragged());
+    QVERIFY(dc->windowBeingDragged()->proxyWindow());
+    QVERIFY(!dock2->isFloating());
+    QCOMPARE(dropArea->placeholderCount(), 0);
+
+    releaseOn(inPlace, titleBar);
+    QVERIFY(!dc->isDragging());
+    QVERIFY(!dock2->isFloating());
+    QCOMPARE(dropArea->count(), 2);
+    QCOMPARE(dropArea->placeholderCount(), 0);
+    QVERIFY(DockRegistry::self()->floatingWindows().isEmpty());
+
+    // 2. Release outside of any window, only now it's detached
+    const QPoint outside = m->geometry().bottomRight() + QPoint(100, 100);
+    drag(titleBar, titleBar->mapToGlobal(QPoint(6, 6)), outside);
+    QVERIFY(!dc->isDragging());
+    QVERIFY(dock2->isFloating());
+    QCOMPARE(dropArea->placeholderCount(), 1);
+
+    QPointer<FloatingWindow> fw2 = dock2->floatingWindow();
+    QVERIFY(fw2);
+    delete fw2;
+}
+
+void TestDocks::tst_deferredDetachOutterDrop()
+{
+    // Tests that dropping a frame on an outer indicator which is over itself isn't an in place drop
+    EnsureTopLevelsDeleted e;
+    Config::self().setFlags(Config::self().flags() | Config::Flag_DeferredDetach);
+
+    auto m = createMainWindow(QSize(800, 500), MainWindowOption_None);
+    auto dock1 = createDockWidget("dock1", new QPushButton("one"));
+    auto dock2 = createDockWidget("dock2", new QPushButton("two"));
+    auto dock3 = createDockWidget("dock3", new QPushButton("three"));
+    m->addDockWidget(dock1, Location_OnTop);
+    m->addDockWidget(dock2, Location_OnBottom);
+    m->addDockWidget(dock3, Location_OnBottom);
+    auto dropArea = m->dropArea();
+    Frame *frame2 = dock2->frame();
+    TitleBar *titleBar = frame2->titleBar();
+    DragController *dc = DragController::instance();
+
+    drag(titleBar, titleBar->mapToGlobal(QPoint(6, 6)), frame2->mapToGlobal(frame2->rect().center()), ButtonAction_Press);
+    QVERIFY(dc->isDragging());
+
+    // The outer left indicator is at the vertical center, which is over dock2
+    const QPoint outterLeft = dropArea->dropIndicatorOverlay()->posForIndicator(DropIndicatorOverlayInterface::DropLocation_OutterLeft);
+    QVERIFY(frame2->geometry().contains(dropArea->mapFromGlobal(outterLeft)));
+
+    drag(titleBar, QPoint(), outterLeft, ButtonAction_Release);
+    QVERIFY(!dc->isDragging());
+    QVERIFY(!dock2->isFloating());
+    QVERIFY(DockRegistry::self()->floatingWindows().isEmpty());
+
+    // It's now a column on the left, spanning the whole height
+    QCOMPARE(dock2->frame()->x(), 0);
+    QCOMPARE(dock2->frame()->height(), dropArea->height());
+    QVERIFY(dock1->frame()->x() > 0);
+    QVERIFY(dropArea->checkSanity());
+}
+
+void TestDocks::tst_eventRecorder()
+{
+    EnsureTopLevelsDeleted e;
+
+    auto m = createMainWindow(QSize(800, 500), MainWindowOption_None);
+    auto dock1 = createDockWidget("dock1", new QPushButton("one"));
+    auto dock2 = createDockWidget("dock2", new QPushButton("two"));
+    m->addDockWidget(dock1, Location_OnLeft);
+    m->addDockWidget(dock2, Location_OnRight);
+
+    // 1. Recording only starts with a press
+    {
+        Debug::EventRecorder recorder(QString(), nullptr);
+        QWindow *window = m->windowHandle();
+        const QPoint localPos = dock1->mapTo(m.get(), dock1->rect().center());
+        const QPoint globalPos = m->mapToGlobal(localPos);
+
+        QMouseEvent move(QEvent::MouseMove, localPos, localPos, globalPos, Qt::NoButton, Qt::NoButton, Qt::NoModifier);
+        qApp->sendEvent(window, &move);
+        QCOMPARE(recorder.numEvents(), 0);
+
+        QMouseEvent press(QEvent::MouseButtonPress, localPos, localPos, globalPos, Qt::LeftButton, Qt::LeftButton, Qt::NoModifier);
+        qApp->sendEvent(window, &press);
+        QMouseEvent release(QEvent::MouseButtonRelease, localPos, localPos, globalPos, Qt::LeftButton, Qt::NoButton, Qt::NoModifier);
+        qApp->sendEvent(window, &release);
+        QCOMPARE(recorder.numEvents(), 2);
+
+        const QJsonObject recording = QJsonDocument::fromJson(recorder.toJson()).object();
+        QVERIFY(!recording.value(QStringLiteral("layout")).toObject().isEmpty());
+        QCOMPARE(recording.value(QStringLiteral("events")).toArray().size(), 2);
+        QCOMPARE(recording.value(QStringLiteral("events")).toArray().at(0).toObject().value(QStringLiteral("x")).toInt(), globalPos.x());
+    }
+
+    // 2. Replay a drag of dock2's title bar to outside of the main window
+    TitleBar *titleBar = dock2->frame()->titleBar();
+    const QPoint pressPos = titleBar->mapToGlobal(QPoint(6, 6));
+    const QPoint outside = m->geometry().bottomRight() + QPoint(100, 100);
+
+    QJsonArray events;
+    auto addEvent = [&events](const char *type, QPoint pos, Qt::MouseButton button, Qt::MouseButtons buttons) {
+        QJsonObject event;
+        event.insert(QStringLiteral("t"), events.size() * 10.0);
+        event.insert(QStringLiteral("type"), QLatin1String(type));
+        event.insert(QStringLiteral("x"), pos.x());
+        event.insert(QStringLiteral("y"), pos.y());
+        event.insert(QStringLiteral("button"), int(button));
+        event.insert(QStringLiteral("buttons"), int(buttons));
+        event.insert(QStringLiteral("modifiers"), 0);
+        events.push_back(event);
+    };
+
+    addEvent("press", pressPos, Qt::LeftButton, Qt::LeftButton);
+    for (int i = 1; i <= 10; ++i)
+        addEvent("move", pressPos + (outside - pressPos) * i / 10, Qt::NoButton, Qt::LeftButton);
+    addEvent("release", outside, Qt::LeftButton, Qt::NoButton);
+
+    QJsonObject recording;
+    recording.insert(QStringLiteral("layout"), QJsonDocument::fromJson(LayoutSaver().serializeLayout()).object());
+    recording.insert(QStringLiteral("events"), events);
+
+    Debug::EventReplayer replayer;
+    QVERIFY(replayer.load(QJsonDocument(recording).toJson()));
+    QCOMPARE(replayer.numEvents(), 12);
+    QVERIFY(replayer.restoreLayout());
+
+    const QByteArray checksumBefore = Debug::EventReplayer::layoutChecksum();
+    const QVector<Debug::EventReplayer::EventTiming> timings = replayer.replay();
+    QCOMPARE(timings.size(), 12);
+    QCOMPARE(timings.constFirst().type, QEvent::MouseButtonPress);
+    QCOMPARE(timings.constLast().globalPos, outside);
+    QVERIFY(!DragController::instance()->isDragging());
+    QVERIFY(dock2->isFloating());
+
+    const QByteArray checksumAfter = Debug::EventReplayer::layoutChecksum();
+    QCOMPARE(checksumAfter.size(), 40);
+    QVERIFY(checksumAfter != checksumBefore);
+    QCOMPARE(Debug::EventReplayer::layoutChecksum(), checksumAfter);
+
+    QPointer<FloatingWindow> fw2 = dock2->floatingWindow();
+    QVERIFY(fw2);
+    delete fw2;
+}
+
+void TestDocks::tst_sharedIndicatorWindow()
+{
+    EnsureTopLevelsDeleted e;
+
+    auto indicatorWindows = [] {
+        QWidgetList windows;
+        const QWidgetList topLevels = qApp->topLevelWidgets();
+        for (QWidget *w : topLevels) {
+            if (w->objectName() == QLatin1String("_docks_IndicatorWindow_Overlay"))
+                windows.push_back(w);
+        }
+        return windows;
+    };
+
+    auto m = createMainWindow(QSize(800, 500), MainWindowOption_None);
+    auto dock1 = createDockWidget("dock1", new QPushButton("one"));
+    auto dock2 = createDockWidget("dock2", new QPushButton("two"));
+    m->addDockWidget(dock1, Location_OnLeft);
+
+    // 1. A single window for both DropAreas, already created before the first hover
+    QWidgetList windows = indicatorWindows();
+    QCOMPARE(windows.size(), 1);
+    QVERIFY(windows.constFirst()->windowHandle());
+    QPointer<QWidget> sharedWindow = windows.constFirst();
+
+    dragFloatingWindowTo(dock2->floatingWindow(), m->dropArea(), DropIndicatorOverlayInterface::DropLocation_Left);
+    QVERIFY(!dock2->isFloating());
+    QVERIFY(!sharedWindow->isVisible());
+
+    // 2. A DropArea created afterwards uses it too
+    dock1->setFloating(true);
+    QVERIFY(dock1->isFloating());
+    QCOMPARE(indicatorWindows(), QWidgetList({ sharedWindow.data() }));
+
+    dragFloatingWindowTo(dock1->floatingWindow(), m->dropArea(), DropIndicatorOverlayInterface::DropLocation_Left);
+    QVERIFY(!dock1->isFloating());
+    QCOMPARE(m->dropArea()->count(), 2);
+    QCOMPARE(indicatorWindows(), QWidgetList({ sharedWindow.data() }));
+    QVERIFY(!sharedWindow->isVisible());
+}
+
+void TestDocks::tst_segmentedIndicatorsHitTest()
+{
+    EnsureTopLevelsDeleted e;
+    const double originalOpacity = Config::self().draggedWindowOpacity();
+
+    auto m = createMainWindow(QSize(800, 500), MainWindowOption_None);
+    auto dock1 = createDockWidget("dock1", new QPushButton("one"));
+    auto dock2 = createDockWidget("dock2", new QPushButton("two"));
+    m->addDockWidget(dock1, Location_OnLeft);
+    m->addDockWidget(dock2, Location_OnRight);
+
+    auto indicators = new SegmentedIndicators(m->dropArea());
+    Config::self().setDraggedWindowOpacity(originalOpacity);
+    indicators->setWindowBeingDragged(true);
+    indicators->setHoveredFrame(dock2->frame());
+
+    const QRect frameRect = dock2->frame()->QWidgetAdapter::geometry();
+    auto hoverAt = [indicators] (QPoint localPos) {
+        return indicators->hover(indicators->mapToGlobal(localPos));
+    };
+
+    QCOMPARE(hoverAt(frameRect.center()), DropIndicatorOverlayInterface::DropLocation_Center);
+    QCOMPARE(hoverAt(QPoint(frameRect.left() + 10, frameRect.center().y())), DropIndicatorOverlayInterface::DropLocation_Left);
+    QCOMPARE(indicators->currentDropLocation(), DropIndicatorOverlayInterface::DropLocation_Left);
+    QCOMPARE(hoverAt(QPoint(frameRect.left() + 60, frameRect.center().y())), DropIndicatorOverlayInterface::DropLocation_None);
+    QCOMPARE(hoverAt(QPoint(10, indicators->rect().center().y())), DropIndicatorOverlayInterface::DropLocation_OutterLeft);
+    QCOMPARE(hoverAt(QPoint(indicators->rect().right() - 10, indicators->rect().center().y())), DropIndicatorOverlayInterface::DropLocation_OutterRight);
+
+    // Hovering another frame gives other segments
+    indicators->setHoveredFrame(dock1->frame());
+    QCOMPARE(hoverAt(QPoint(frameRect.left() + 10, frameRect.center().y())), DropIndicatorOverlayInterface::DropLocation_None);
+
+    indicators->setWindowBeingDragged(false);
+    delete indicators;
+}
+
+void TestDocks::tst_frameContainingPos()
+{
+    EnsureTopLevelsDeleted e;
+
+    auto m = createMainWindow(QSize(800, 500), MainWindowOption_None);
+    auto dock1 = createDockWidget("dock1", new QPushButton("one"));
+    auto dock2 = createDockWidget("dock2", new QPushButton("two"));
+    auto dock3 = createDockWidget("dock3", new QPushButton("three"));
+    m->addDockWidget(dock1, Location_OnLeft);
+    m->addDockWidget(dock2, Location_OnRight);
+    m->addDockWidget(dock3, Location_OnBottom, dock2);
+    auto dropArea = m->dropArea();
+
+    auto centerOf = [] (DockWidgetBase *dw) {
+        Frame *frame = dw->frame();
+        return frame->mapToGlobal(frame->rect().center());
+    };
+
+    for (DockWidgetBase *dw : { dock1, dock2, dock3 })
+        QCOMPARE(dropArea->frameContainingPos(centerOf(dw)), dw->frame());
+    QVERIFY(!dropArea->frameContainingPos(m->geometry().bottomRight() + QPoint(100, 100)));
+
+    // The window moved, the cached rects move with it
+    m->move(m->pos() + QPoint(30, 20));
+    for (DockWidgetBase *dw : { dock1, dock2, dock3 })
+        QCOMPARE(dropArea->frameContainingPos(centerOf(dw)), dw->frame());
+
+    // The layout changed, it's rebuilt
+    auto dock4 = createDockWidget("dock4", new QPushButton("four"));
+    m->addDockWidget(dock4, Location_OnTop);
+    for (DockWidgetBase *dw : { dock1, dock2, dock3, dock4 })
+        QCOMPARE(dropArea->frameContainingPos(centerOf(dw)), dw->frame());
+
+    dock1->close();
+    QVERIFY(dropArea->frameContainingPos(centerOf(dock2)) == dock2->frame());
+    QVERIFY(dropArea->frameContainingPos(centerOf(dock4)) == dock4->frame());
+
+    // A nested container which is pushed by a separator moves without resizing. Its items keep
+    // their geometry, as it's relative to the container, but the cache must still be rebuilt.
+    auto m2 = createMainWindow(QSize(800, 500), MainWindowOption_None, "m2");
+    auto dock5 = createDockWidget("dock5", new QPushButton("five"));
+    auto dock6 = createDockWidget("dock6", new QPushButton("six"));
+    auto dock7 = createDockWidget("dock7", new QPushButton("seven"));
+    auto dock8 = createDockWidget("dock8", new QPushButton("eight"));
+    m2->addDockWidget(dock5, Location_OnLeft);
+    m2->addDockWidget(dock6, Location_OnRight);
+    m2->addDockWidget(dock7, Location_OnBottom, dock6);
+    m2->addDockWidget(dock8, Location_OnRight);
+    auto dropArea2 = m2->dropArea();
+
+    ItemContainer *root = dropArea2->rootItem();
+    Item *item6 = dropArea2->itemForFrame(dock6->frame());
+    ItemContainer *container = item6->parentContainer();
+    QVERIFY(container != root);
+    const QVector<Separator*> separators = root->separators();
+    QCOMPARE(separators.size(), 2);
+
+    // Squeeze the container to its minimum width, so the next move pushes it
+    root->requestSeparatorMove(separators[1], root->minPosForSeparator_global(separators[1]) - separators[1]->position());
+    QCOMPARE(dropArea2->frameContainingPos(centerOf(dock6)), dock6->frame());
+
+    const QSize containerSize = container->size();
+    const QRect item6Geometry = item6->geometry();
+    root->requestSeparatorMove(separators[0], 50);
+    QCOMPARE(container->size(), containerSize);
+    QCOMPARE(item6->geometry(), item6Geometry);
+    for (DockWidgetBase *dw : { dock5, dock6, dock7, dock8 })
+        QCOMPARE(dropArea2->frameContainingPos(centerOf(dw)), dw->frame());
+}
+
+void TestDocks::tst_floatingWindowPool()
+{
+    EnsureTopLevelsDeleted e;
+
+    auto m = createMainWindow(QSize(800, 500), MainWindowOption_None);
+    Config::self().setFloatingWindowPoolSize(2);
+    FloatingWindowPool *pool = FloatingWindowPool::self();
+
+    // 1. Windows are created in advance, but aren't visible to the rest of the framework
+    QTRY_COMPARE(pool->size(), 2);
+    QVERIFY(DockRegistry::self()->floatingWindows().isEmpty());
+
+    // 2. Floating takes them from the pool
+    auto dock1 = createDockWidget("dock1", new QPushButton("one"), {}, /*show=*/ false);
+    auto dock2 = createDockWidget("dock2", new QPushButton("two"), {}, /*show=*/ false);
+    dock1->show();
+    dock2->show();
+    QCOMPARE(pool->size(), 0);
+    QPointer<FloatingWindow> fw1 = dock1->floatingWindow();
+    QPointer<FloatingWindow> fw2 = dock2->floatingWindow();
+    QVERIFY(fw1);
+    QVERIFY(fw2);
+    QCOMPARE(DockRegistry::self()->floatingWindows().size(), 2);
+
+    // 3. Empty windows go back to the pool instead of being deleted
+    dock1->close();
+    dock2->close();
+    QTRY_COMPARE(pool->size(), 2);
+    QVERIFY(fw1);
+    QVERIFY(fw2);
+    QVERIFY(pool->contains(fw1));
+    QVERIFY(pool->contains(fw2));
+    QVERIFY(!fw1->isVisible());
+    QVERIFY(fw1->beingDeleted());
+    QVERIFY(DockRegistry::self()->floatingWindows().isEmpty());
+
+    // 4. And are reused
+    dock1->show();
+    FloatingWindow *fw = dock1->floatingWindow();
+    QVERIFY(fw == fw1 || fw == fw2);
+    QVERIFY(fw->isVisible());
+    QVERIFY(!fw->beingDeleted());
+    QCOMPARE(fw->dockWidgets().size(), 1);
+    QCOMPARE(fw->dockWidgets().constFirst(), dock1);
+    QCOMPARE(DockRegistry::self()->floatingWindows().size(), 1);
+
+    // 5. The pool is full again, so this one is really deleted
+    QTRY_COMPARE(pool->size(), 2);
+    QPointer<FloatingWindow> reused = fw;
+    delete dock2;
+    delete dock1;
+    QVERIFY(Testing::waitForDeleted(reused));
+
+    Config::self().setFloatingWindowPoolSize(0);
+    QCOMPARE(pool->size(), 0);
+}
+
+void TestDocks::tst_widgetFactory()
+{
+    EnsureTopLevelsDeleted e;
+
+    auto m = createMainWindow(QSize(800, 500), MainWindowOption_None, {}, /*show=*/ false);
+    auto dock1 = createDockWidget("dock1", new QPushButton("one"), {}, /*show=*/ false);
+    auto dock2 = new DockWidgetType("dock2");
+    int numCreated = 0;
+    dock2->setWidgetFactory([&numCreated] {
+        numCreated++;
+        return new QPushButton("two");
+    }, QSize(300, 200));
+
+    QVERIFY(!dock2->widget());
+    QCOMPARE(dock2->minimumSize(), QSize(300, 200));
+
+    // 1. Added as a background tab, it's not created, but its size is honoured
+    m->addDockWidget(dock1, Location_OnLeft);
+    dock1->addDockWidgetAsTab(dock2);
+    dock1->setAsCurrentTab();
+    m->show();
+    QVERIFY(QTest::qWaitForWindowExposed(m->windowHandle()));
+    QCOMPARE(numCreated, 0);
+    QVERIFY(!dock2->widget());
+    Frame *frame = dock1->frame();
+    QCOMPARE(frame->dockWidgetsMinSize().expandedTo(QSize(300, 200)), frame->dockWidgetsMinSize());
+
+    // 2. Created once its tab is current
+    dock2->setAsCurrentTab();
+    QCOMPARE(numCreated, 1);
+    QVERIFY(dock2->widget());
+    QTRY_VERIFY(dock2->widget()->isVisible());
+    QCOMPARE(dock2->widget()->parentWidget(), dock2);
+
+    // 3. Only once
+    dock1->setAsCurrentTab();
+    dock2->setAsCurrentTab();
+    QCOMPARE(numCreated, 1);
+
+    // 4. A dock widget shown floating creates it too
+    auto dock3 = new DockWidgetType("dock3");
+    dock3->setWidgetFactory([] { return new QPushButton("three"); });
+    QVERIFY(!dock3->widget());
+    dock3->show();
+    QVERIFY(dock3->widget());
+    delete dock3->window();
+}
+
+void TestDocks::tst_hibernation()
+{
+    EnsureTopLevelsDeleted e;
+
+    auto m = createMainWindow(QSize(800, 500), MainWindowOption_None);
+    auto dock1 = createDockWidget("dock1", new QPushButton("one"), {}, /*show=*/ false);
+    auto dock2 = new DockWidgetType("dock2");
+    int numCreated = 0;
+    dock2->setWidgetFactory([&numCreated] {
+        numCreated++;
+        auto button = new QPushButton("two");
+        button->setMinimumSize(QSize(300, 250));
+        return button;
+    });
+
+    QStringList savedTexts;
+    dock2->setHibernation(50, [&savedTexts] (QWidgetOrQuick *guest) {
+        savedTexts << qobject_cast<QPushButton*>(guest)->text();
+        return qint64(1000);
+    });
+
+    m->addDockWidget(dock1, Location_OnLeft);
+    dock1->addDockWidgetAsTab(dock2);
+    QCOMPARE(numCreated, 1);
+    QPointer<QWidgetOrQuick> guest = dock2->widget();
+    Frame *frame = dock2->frame();
+    const QSize minSize = frame->dockWidgetsMinSize();
+    QVERIFY(minSize.width() >= 300);
+    QVERIFY(minSize.height() >= 250);
+    const QSize guestMinSize = dock2->cachedMinSize();
+
+    // 1. Hidden behind another tab for long enough, the widget is released
+    dock1->setAsCurrentTab();
+    QTRY_VERIFY(dock2->isHibernated());
+    QVERIFY(!guest);
+    QVERIFY(!dock2->widget());
+    QCOMPARE(savedTexts, QStringList({ QStringLiteral("two") }));
+    QCOMPARE(frame->dockWidgetsMinSize(), minSize);
+    QCOMPARE(dock2->cachedMinSize(), guestMinSize);
+    QCOMPARE(DockRegistry::self()->hibernatedBytes(), 1000);
+
+    // 2. And recreated when shown again
+    dock2->setAsCurrentTab();
+    QCOMPARE(numCreated, 2);
+    QVERIFY(dock2->widget());
+    QVERIFY(!dock2->isHibernated());
+    QCOMPARE(DockRegistry::self()->hibernatedBytes(), 0);
+    QCOMPARE(frame->dockWidgetsMinSize(), minSize);
+
+    // 3. While visible it's kept
+    QTest::qWait(200);
+    QVERIFY(!dock2->isHibernated());
+    QCOMPARE(numCreated, 2);
+}
+
+void TestDocks::tst_framePool()
+{
+    EnsureTopLevelsDeleted e;
+
+    auto m = createMainWindow(QSize(800, 500), MainWindowOption_None);
+    Config::self().setFramePoolSize(2);
+    FramePool *pool = FramePool::self();
+    pool->resetStatistics();
+
+    auto dock1 = createDockWidget("dock1", new QPushButton("one"), {}, /*show=*/ false);
+    auto dock2 = createDockWidget("dock2", new QPushButton("two"), {}, /*show=*/ false);
+    m->addDockWidget(dock1, Location_OnLeft);
+    m->addDockWidget(dock2, Location_OnRight);
+    QCOMPARE(pool->size(), 0);
+    QCOMPARE(pool->hits(), 0);
+    QVERIFY(pool->misses() >= 2);
+
+    MultiSplitter *layout = m->multiSplitter();
+    QPointer<Frame> frame2 = dock2->frame();
+
+    // 1. The emptied frame goes into the pool instead of being deleted
+    dock2->setFloating(true);
+    QTRY_COMPARE(pool->size(), 1);
+    QVERIFY(frame2);
+    QVERIFY(frame2->beingDeletedLater());
+    QVERIFY(!frame2->isVisible());
+    QVERIFY(!DockRegistry::self()->frames().contains(frame2));
+    QVERIFY(layout->checkSanity());
+
+    // 2. And is reused when docking back
+    QPointer<FloatingWindow> fw = dock2->floatingWindow();
+    dock2->setFloating(false);
+    QCOMPARE(pool->hits(), 1);
+    QCOMPARE(dock2->frame(), frame2.data());
+    QVERIFY(!frame2->beingDeletedLater());
+    QVERIFY(frame2->isVisible());
+    QVERIFY(DockRegistry::self()->frames().contains(frame2));
+    QCOMPARE(layout->frames().size(), 2);
+    QVERIFY(layout->checkSanity());
+    QVERIFY(Testing::waitForDeleted(fw));
+
+    // 3. Pooled frames are deleted when the pool is disabled
+    Config::self().setFramePoolSize(0);
+    QCOMPARE(pool->size(), 0);
+}
+
+void TestDocks::tst_coalescedTitleUpdates()
+{
+    EnsureTopLevelsDeleted e;
+
+    auto dock1 = createDockWidget("dock1", new QPushButton("one"));
+    Frame *frame = dock1->frame();
+    TitleBar *tb = frame->titleBar();
+    FloatingWindow *fw = dock1->floatingWindow();
+    QVERIFY(fw);
+
+    const QString oldTitle = tb->title();
+    const int numCoalesced = frame->dbg_numCoalescedUpdates();
+    for (int i = 0; i < 10; ++i)
+        dock1->setTitle(QString::number(i));
+
+    // The tab is renamed right away, but the title bars only once control returns to the event loop
+    auto tabBar = static_cast<FrameWidget *>(frame)->tabBar();
+    QCOMPARE(tabBar->tabText(0), QStringLiteral("9"));
+    QCOMPARE(tb->title(), oldTitle);
+    QCOMPARE(frame->dbg_numCoalescedUpdates(), numCoalesced + 9);
+    QTRY_COMPARE(tb->title(), QStringLiteral("9"));
+    QCOMPARE(fw->titleBar()->title(), QStringLiteral("9"));
+    QCOMPARE(fw->windowTitle(), QStringLiteral("9"));
+
+    // Button updates are coalesced too
+    auto dock2 = createDockWidget("dock2", new QPushButton("two"), DockWidgetBase::Option_NotClosable, /*show=*/ false);
+    const int numCoalescedButtons = tb->dbg_numCoalescedUpdates();
+    dock1->addDockWidgetAsTab(dock2);
+    dock2->close();
+    dock1->addDockWidgetAsTab(dock2);
+    QVERIFY(tb->dbg_numCoalescedUpdates() > numCoalescedButtons);
+    QTRY_VERIFY(!tb->isCloseButtonEnabled());
+
+    delete dock1->window();
+}
+
+void TestDocks::tst_cachedSizeConstraints()
+{
+    EnsureTopLevelsDeleted e;
+
+    auto m = createMainWindow(QSize(800, 500), MainWindowOption_None);
+    auto w1 = new QWidget();
+    auto w2 = new QWidget();
+    auto dock1 = createDockWidget("dock1", w1, {}, /*show=*/ false);
+    auto dock2 = createDockWidget("dock2", w2, {}, /*show=*/ false);
+    m->addDockWidget(dock1, Location_OnLeft);
+    m->addDockWidget(dock2, Location_OnRight);
+
+    MultiSplitter *layout = m->multiSplitter();
+    Item *item1 = layout->itemForFrame(dock1->frame());
+    Item *item2 = layout->itemForFrame(dock2->frame());
+    QCOMPARE(dock1->cachedMinSize(), Layouting::Widget::widgetMinSize(dock1));
+
+    // Queries don't recompute anything until the sizes are invalidated
+    const int numComputations = dock1->dbg_numSizeComputations();
+    dock1->cachedMinSize();
+    dock1->cachedMaxSize();
+    dock1->frame()->minSize();
+    QCOMPARE(dock1->dbg_numSizeComputations(), numComputations);
+
+    QTest::qWait(100); // Let the layout settle, so nothing else is pending
+    QSignalSpy spy1(dock1->frame(), &Frame::layoutInvalidated);
+    QSignalSpy spy2(dock2->frame(), &Frame::layoutInvalidated);
+
+    // A burst of changes is propagated once control returns to the event loop
+    w1->setMinimumSize(QSize(300, 300));
+    w1->setMinimumSize(QSize(310, 310));
+    w2->setMinimumSize(QSize(200, 200));
+    QCOMPARE(spy1.count(), 0);
+    QCOMPARE(spy2.count(), 0);
+    QTRY_VERIFY(item1->minSize().width() >= 310);
+    QTRY_VERIFY(item2->minSize().width() >= 200);
+    QTest::qWait(100); // No late duplicates
+    QCOMPARE(spy1.count(), 1);
+    QCOMPARE(spy2.count(), 1);
+
+    // Computed again once, and cached until the next invalidation
+    const int numComputationsAfter = dock1->dbg_numSizeComputations();
+    QVERIFY(numComputationsAfter > numComputations);
+    dock1->cachedMinSize();
+    dock1->cachedMaxSize();
+    dock1->frame()->minSize();
+    QCOMPARE(dock1->dbg_numSizeComputations(), numComputationsAfter);
+
+    QCOMPARE(dock1->cachedMinSize(), Layouting::Widget::widgetMinSize(dock1));
+    QCOMPARE(dock1->cachedMaxSize(), Layouting::Widget::widgetMaxSize(dock1));
+    QCOMPARE(dock2->cachedMinSize(), Layouting::Widget::widgetMinSize(dock2));
+    QCOMPARE(item1->minSize(), dock1->frame()->minSize());
+    QCOMPARE(item2->minSize(), dock2->frame()->minSize());
+    QVERIFY(layout->checkSanity());
+}
+
+void TestDocks::tst_uniformTabWidths()
+{
+    EnsureTopLevelsDeleted e;
+    Config::self().setFlags(Config::Flag_UniformTabWidths | Config::Flag_TabsHaveCloseButton);
+
+    auto m = createMainWindow();
+    const int numDocks = 150;
+    DockWidgetBase::List docks;
+    for (int i = 0; i < numDocks; ++i) {
+        auto dock = createDockWidget(QStringLiteral("dock%1").arg(i), new QPushButton(QStringLiteral("%1").arg(i)), {}, false);
+        m->addDockWidgetAsTab(dock);
+        docks << dock;
+    }
+
+    Frame *frame = docks.constFirst()->frame();
+    QCOMPARE(frame->dockWidgets(), docks);
+    QVERIFY(frame->containsDockWidget(docks.constLast()));
+
+    // Tabs aren't measured individually and only the current one can be closed
+    auto frameWidget = static_cast<FrameWidget *>(frame);
+    auto tabBar = frameWidget->tabBar();
+    QVERIFY(tabBar->usesScrollButtons());
+    QVERIFY(!static_cast<QTabWidget *>(frameWidget->tabWidget()->asWidget())->tabsClosable());
+    docks.at(10)->setTitle(QStringLiteral("A much longer title than the others"));
+    QCOMPARE(tabBar->tabRect(10).size(), tabBar->tabRect(0).size());
+
+    // The overflow menu lists every dock widget and can be filtered
+    auto tabWidget = static_cast<TabWidgetWidget *>(frameWidget->tabWidget());
+    QMenu *menu = tabWidget->overflowMenu();
+    QVERIFY(menu);
+    Q_EMIT menu->aboutToShow();
+    const QList<QAction *> actions = menu->actions().mid(2);
+    QCOMPARE(actions.size(), numDocks);
+
+    auto filter = menu->findChild<QLineEdit *>();
+    QVERIFY(filter);
+    filter->setText(QStringLiteral("LONGER"));
+    int numVisible = 0;
+    for (QAction *action : actions) {
+        if (action->isVisible())
+            numVisible++;
+    }
+    QCOMPARE(numVisible, 1);
+
+    actions.at(10)->trigger();
+    QCOMPARE(frame->currentDockWidget(), docks.at(10));
+
+    // The list of dock widgets follows removals
+    delete docks.takeAt(20);
+    QCOMPARE(frame->dockWidgets(), docks);
+    QCOMPARE(frame->dockWidgetCount(), numDocks - 1);
+
+    // Reusing the menu doesn't duplicate entries
+    Q_EMIT menu->aboutToShow();
+    QCOMPARE(menu->actions().size(), numDocks - 1 + 2);
+    QVERIFY(filter->text().isEmpty());
+}
+
+void TestDocks::tst_overlayFrameReused()
+{
+    EnsureTopLevelsDeleted e;
+    KDDockWidgets::Config::self().setFlags(KDDockWidgets::Config::Flag_AutoHideSupport);
+    auto m1 = createMainWindow(QSize(1000, 1000), MainWindowOption_None);
+    auto dw1 = createDockWidget("dw1", new QPushButton("one"));
+    auto dw2 = createDockWidget("dw2", new QPushButton("two"));
+    m1->addDockWidget(dw1, Location_OnBottom);
+    m1->addDockWidget(dw2, Location_OnLeft);
+    m1->moveToSideBar(dw1);
+    m1->moveToSideBar(dw2);
+
+    m1->overlayOnSideBar(dw1);
+    QPointer<Frame> overlayFrame = dw1->frame();
+    QVERIFY(overlayFrame);
+    QVERIFY(overlayFrame->isOverlayed());
+    QVERIFY(overlayFrame->isVisible());
+    QVERIFY(dw1->isOverlayed());
+
+    // The frame stays around, hidden
+    m1->clearSideBarOverlay();
+    QVERIFY(!dw1->isOverlayed());
+    QVERIFY(!dw1->frame());
+    QTest::qWait(100); // Would have been deleted by now
+    QVERIFY(overlayFrame);
+    QVERIFY(overlayFrame->isEmpty());
+    QVERIFY(!overlayFrame->isVisible());
+
+    // Overlaying again reuses it
+    m1->overlayOnSideBar(dw1);
+    QCOMPARE(dw1->frame(), overlayFrame.data());
+    QVERIFY(overlayFrame->isVisible());
+
+    // Only a dock widget dismissed twice in a row is grabbed. Then the last rendering is shown
+    // until the dock widget is laid out
+    QVERIFY(!overlayFrame->findChild<QLabel *>(QStringLiteral("_docks_OverlaySnapshot")));
+    m1->clearSideBarOverlay();
+    m1->overlayOnSideBar(dw1);
+    auto snapshot = overlayFrame->findChild<QLabel *>(QStringLiteral("_docks_OverlaySnapshot"));
+    QVERIFY(snapshot);
+    QVERIFY(snapshot->isVisible());
+    QTRY_VERIFY(!snapshot->isVisible());
+
+    // Resizing the main window drops the snapshot
+    m1->clearSideBarOverlay();
+    m1->resize(m1->size() + QSize(50, 50));
+    m1->overlayOnSideBar(dw1);
+    QVERIFY(!snapshot->isVisible());
+
+    // Another dock widget uses the same frame
+    m1->toggleOverlayOnSideBar(dw2);
+    QVERIFY(!dw1->isOverlayed());
+    QVERIFY(dw2->isOverlayed());
+    QCOMPARE(dw2->frame(), overlayFrame.data());
+
+    // Closing the overlayed dock widget hides the frame
+    dw2->close();
+    QVERIFY(!dw2->isOverlayed());
+    QVERIFY(!m1->overlayedDockWidget());
+    QVERIFY(!overlayFrame->isVisible());
+
+    delete dw1;
+    delete dw2;
+}
+
+void TestDocks::tst_dropAreaIndexSkipsOverlay()
+{
+    EnsureTopLevelsDeleted e;
+    KDDockWidgets::Config::self().setFlags(KDDockWidgets::Config::Flag_AutoHideSupport);
+    auto m1 = createMainWindow(QSize(1000, 1000), MainWindowOption_None);
+    auto dw1 = createDockWidget("dw1", new QPushButton("one"));
+    auto dw2 = createDockWidget("dw2", new QPushButton("two"));
+    m1->addDockWidget(dw1, Location_OnBottom);
+    m1->addDockWidget(dw2, Location_OnTop);
+    m1->moveToSideBar(dw1);
+    m1->overlayOnSideBar(dw1);
+    Frame *overlayFrame = dw1->frame();
+    QVERIFY(overlayFrame);
+    QVERIFY(overlayFrame->isVisible());
+
+    auto dw3 = createDockWidget("dw3", new QPushButton("three"));
+    FloatingWindow *fw3 = dw3->floatingWindow();
+    DropAreaIndex index;
+    WindowBeingDragged wbd(fw3);
+    index.rebuild(&wbd, nullptr);
+
+    // The overlay is drawn on top of the drop area, nothing can be dropped behind it
+    DropArea *dropArea = m1->dropArea();
+    const QPoint overlayCenter = overlayFrame->mapToGlobal(overlayFrame->rect().center());
+    QVERIFY(dropArea->rect().contains(dropArea->mapFromGlobal(overlayCenter)));
+    WidgetType *topLevel = index.topLevelAt(overlayCenter);
+    QVERIFY(topLevel == m1.get());
+    QVERIFY(!index.dropAreaAt(topLevel, overlayCenter));
+
+    // Outside of the overlay the drop area is still found
+    const QPoint top = dropArea->mapToGlobal(QPoint(dropArea->width() / 2, 10));
+    QVERIFY(!overlayFrame->geometry().contains(overlayFrame->parentWidget()->mapFromGlobal(top)));
+    QCOMPARE(index.dropAreaAt(topLevel, top), dropArea);
+
+    delete fw3;
+}
+
 #endif
 
+void TestDocks::tst_bulkClear()
+{
+    EnsureTopLevelsDeleted e;
+    auto m = createMainWindow(QSize(1000, 1000), MainWindowOption_None);
+    auto dock1 = createDockWidget("dock1", Qt::red);
+    auto dock2 = createDockWidget("dock2", Qt::green);
+    m->addDockWidget(dock1, Location_OnLeft);
+    m->addDockWidget(dock2, Location_OnRight);
+
+    auto dock3 = createDockWidget("dock3", Qt::blue);
+    auto dock4 = createDockWidget("dock4", Qt::yellow);
+    dock3->addDockWidgetToContainingWindow(dock4, Location_OnRight);
+    QPointer<FloatingWindow> fw3 = dock3->floatingWindow();
+    QVERIFY(fw3);
+
+    // Not cleared, as if the layout didn't know about it
+    auto dock5 = createDockWidget("dock5", Qt::black);
+    QPointer<FloatingWindow> fw5 = dock5->floatingWindow();
+    QVERIFY(fw5);
+
+    LayoutSaver saver;
+    const QByteArray saved = saver.serializeLayout();
+
+    DockRegistry::self()->clear({ dock1, dock2, dock3, dock4 }, { m.get() }, {});
+
+    for (DockWidgetBase *dw : { dock1, dock2, dock3, dock4 }) {
+        QVERIFY(!dw->isVisible());
+        QVERIFY(!dw->lastPositions().isValid());
+    }
+
+    // The layouts were cleared at once, instead of shrinking one dock widget at a time
+    QCOMPARE(m->multiSplitter()->count(), 0);
+    QVERIFY(m->multiSplitter()->checkSanity());
+    QVERIFY(fw3->beingDeleted());
+    QCOMPARE(fw3->dropArea()->count(), 0);
+    QVERIFY(Testing::waitForDeleted(fw3));
+
+    QVERIFY(fw5);
+    QVERIFY(!fw5->beingDeleted());
+    QVERIFY(dock5->isVisible());
+
+    // Restoring works from the cleared state
+    QVERIFY(saver.restoreLayout(saved));
+    QVERIFY(dock1->isInMainWindow());
+    QVERIFY(dock2->isInMainWindow());
+    QVERIFY(dock3->floatingWindow());
+    QCOMPARE(dock3->floatingWindow(), dock4->floatingWindow());
+    QVERIFY(m->multiSplitter()->checkSanity());
+
+    delete dock3->window();
+    delete dock5->window();
+}
+
+void TestDocks::tst_fastTeardown()
+{
+    // Tests that deleting a window with many frames unregisters everything it contained
+    EnsureTopLevelsDeleted e;
+    DockRegistry *registry = DockRegistry::self();
+
+    // Keeps the registry alive
+    auto survivor = createDockWidget("survivor", Qt::black);
+
+    auto m = createMainWindow(QSize(1000, 1000), MainWindowOption_HasCentralFrame);
+    QVector<QPointer<DockWidgetBase>> docks;
+    for (int i = 0; i < 30; ++i) {
+        auto dw = createDockWidget(QStringLiteral("dock%1").arg(i), Qt::red);
+        if (i % 3 == 2)
+            docks.constLast()->addDockWidgetAsTab(dw);
+        else
+            m->addDockWidget(dw, i % 2 ? Location_OnRight : Location_OnBottom);
+        docks.push_back(dw);
+    }
+
+    auto dock30 = createDockWidget("dock30", Qt::green);
+    auto dock31 = createDockWidget("dock31", Qt::blue);
+    dock30->addDockWidgetToContainingWindow(dock31, Location_OnRight);
+    QPointer<FloatingWindow> fw = dock30->floatingWindow();
+    QVERIFY(fw);
+    QCOMPARE(fw->frames().size(), 2);
+
+    QCOMPARE(registry->dockwidgets().size(), 33);
+    const int numFramesBefore = registry->frames().size();
+
+    QPointer<MultiSplitter> layout = m->multiSplitter();
+    const int numMainWindowFrames = layout->frames().size();
+    QVERIFY(numMainWindowFrames > 1);
+    m.reset();
+    QVERIFY(!layout);
+
+    for (const QPointer<DockWidgetBase> &dw : qAsConst(docks))
+        QVERIFY(!dw);
+
+    QCOMPARE(registry->dockwidgets().size(), 3);
+    QCOMPARE(registry->frames().size(), numFramesBefore - numMainWindowFrames);
+    QVERIFY(registry->dockwidgets().contains(dock30));
+
+    delete fw;
+    QCOMPARE(registry->dockwidgets().size(), 1);
+    QVERIFY(registry->dockwidgets().contains(survivor));
+    QCOMPARE(registry->frames().size(), 1);
+    QVERIFY(registry->frames().constFirst()->containsDockWidget(survivor));
+
+    delete survivor->window();
+}
+
 void TestDocks::tst_floatingAction()
 {
     // Tests DockWidget::floatAction()
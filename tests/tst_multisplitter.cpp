@@ -229,7 +229,7 @@ static bool serializeDeserializeTest(const std::unique_ptr<ItemContainer> &root)
     const QVariantMap serialized = root->toVariantMap();
     ItemContainer root2(root->hostWidget());
 
-    QHash<QString, Widget*> widgets;
+    QHash<qint64, Widget*> widgets;
     const Item::List originalItems = root->items_recursive();
     for (Item *item : originalItems)
         if (auto w = static_cast<MyGuestWidget*>(item->guestAsQObject()))
@@ -93,11 +93,17 @@ struct EnsureTopLevelsDeleted
     EnsureTopLevelsDeleted()
         : m_originalFlags(Config::self().flags())
         , m_originalSeparatorThickness(Config::self().separatorThickness())
+        , m_originalFloatingWindowPoolSize(Config::self().floatingWindowPoolSize())
+        , m_originalFramePoolSize(Config::self().framePoolSize())
     {
     }
 
     ~EnsureTopLevelsDeleted()
     {
+        // Restore the pools first, so their hidden windows aren't reported as leaked
+        Config::self().setFloatingWindowPoolSize(m_originalFloatingWindowPoolSize);
+        Config::self().setFramePoolSize(m_originalFramePoolSize);
+
         const QWindowList topLevels = qApp->topLevelWindows();
 
         auto dr = DockRegistry::self();
@@ -116,6 +122,8 @@ struct EnsureTopLevelsDeleted
 
     const Config::Flags m_originalFlags;
     const int m_originalSeparatorThickness;
+    const int m_originalFloatingWindowPoolSize;
+    const int m_originalFramePoolSize;
 };
 
 bool shouldBlacklistWarning(const QString &msg, const QString &category = {});